@@ -0,0 +1,932 @@
+/* ============================================================
+   Detective Quest - Benchmark das estruturas do Capítulo Final
+   ------------------------------------------------------------
+   Inclui A5_detetiveMestre.c inteiro (sem a main) e mede as
+   funções de lá diretamente, sem cópias.
+
+   Compilação:  gcc -O2 -pthread -o benchDetetive A5_benchDetetive.c
+   Execução:    ./benchDetetive [--rapido] [--saida arquivo]
+                ./benchDetetive --comparar [quantidade_de_strings] [salas]
+                (ou só os números, como antes)
+
+   Suíte (padrão): cada operação do núcleo em várias escalas (10^3 a
+   10^6; --rapido para em 10^4) e distribuições de chave, em lotes
+   cronometrados. Por caso: ns/op médio, percentis p50/p90/p99 dos
+   lotes (ns/op dentro de cada lote), alocações e bytes pedidos ao
+   malloc por op. Vai para a tela e, separado por tabulações, para
+   bench_output.txt (uma linha por caso; '#' = comentário), para
+   comparar versões com diff ou uma planilha.
+   - inserirPista: ordens aleatórias, crescentes e repetidas;
+   - inserirNaHash: pistas aleatórias e sequenciais, tabela e
+     internação novas a cada repetição;
+   - encontrarSuspeito: consultas uniformes, concentradas (90% em
+     1% das pistas) e ausentes;
+   - pistaDaSala: salas da tabela fixa e salas fora dela;
+   - percorrerInOrder: op = um nó visitado, lote = uma travessia;
+   - veredito (julgarSuspeito) e rankingSuspeitos sobre um
+     tabuleiro com 8 ou 1024 suspeitos;
+   - montagem e liberação do mapa: a mansão embutida (montarMapa +
+     popularMapaPistas), gerarMansao nas três formas e
+     compactarMansao; op = uma sala.
+
+   Comparações (--comparar):
+   - hashTexto() x djb2 (referência byte a byte) em strings do
+     tamanho de pistas, em ns por hash e em distribuição
+     (maior balde ocupado em 2^16 baldes);
+   - encontrarSuspeito() recalculando o hash x com o hash em cache
+     x encontrarSuspeitoId() com a pista já internada;
+   - julgamento de todos os suspeitos contra o mesmo tabuleiro:
+     percorrendo a BST (como antes) x contadores (pistasContra)
+     e o ranking completo (rankingSuspeitos);
+   - árvore de ponteiros x forma compacta (compactarMansao) numa
+     mansão aleatória gerada (2M salas por padrão; 10M para o caso
+     grande): descidas ao acaso, em ns por nível, e o resolvedor
+     inteiro em uma thread, e a montagem do resumo das subárvores
+     (--dicas). Sem contadores de hardware aqui, o tempo
+     das descidas é a medida de faltas de cache (cada nível fundo
+     é uma falta provável).
+   ============================================================ */
+
+#define _POSIX_C_SOURCE 200809L  /* sigaction (A5_estatisticas.h) */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Contagem de alocações: todo malloc/calloc/realloc do capítulo passa
+   por aqui (as macros valem para o arquivo incluído abaixo). free e o
+   aligned_alloc do --threads não entram; a suíte só lê a diferença
+   dos contadores em volta de cada lote. */
+static unsigned long long alocacoes, bytesAlocados;
+
+static void *benchMalloc(size_t n) {
+    alocacoes++;
+    bytesAlocados += n;
+    return malloc(n);
+}
+
+static void *benchCalloc(size_t n, size_t tam) {
+    alocacoes++;
+    bytesAlocados += n * tam;
+    return calloc(n, tam);
+}
+
+static void *benchRealloc(void *p, size_t n) {
+    alocacoes++;
+    bytesAlocados += n;
+    return realloc(p, n);
+}
+
+#define malloc(n)     benchMalloc(n)
+#define calloc(n, t)  benchCalloc(n, t)
+#define realloc(p, n) benchRealloc(p, n)
+
+#define DQ_SEM_MAIN
+#include "A5_detetiveMestre.c"
+
+#include <time.h>
+
+/* djb2 original (referência): um byte por iteração. */
+static uint64_t djb2Referencia(const char *str) {
+    const unsigned char *p = (const unsigned char *)str;
+    unsigned long hash = 5381;
+    int c;
+    while ((c = *p++)) hash = ((hash << 5) + hash) + (unsigned long)c;
+    return hash;
+}
+
+static double agoraNs(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* xorshift64*: gerador determinístico para as entradas do benchmark */
+static uint64_t estadoAleatorio = 0x2545F4914F6CDD1Dull;
+static uint64_t proximoAleatorio(void) {
+    estadoAleatorio ^= estadoAleatorio >> 12;
+    estadoAleatorio ^= estadoAleatorio << 25;
+    estadoAleatorio ^= estadoAleatorio >> 27;
+    return estadoAleatorio * 0x2545F4914F6CDD1Dull;
+}
+
+/* Pistas sintéticas: duas palavras do vocabulário + número, 10 a ~40 bytes */
+static const char *PALAVRAS[] = {
+    "Pegadas", "lama", "Almofada", "Perfume", "forte", "Livro", "raro",
+    "Janela", "entreaberta", "Luva", "couro", "Taca", "batom", "Rastro",
+    "acucar", "Terra", "revolvida", "Bilhete", "rasgado", "Chave", "dourada",
+};
+#define NUM_PALAVRAS (sizeof(PALAVRAS) / sizeof(PALAVRAS[0]))
+
+static char **gerarPistas(Arena *a, size_t n) {
+    char **v = (char **)malloc(n * sizeof(char *));
+    if (!v) { fprintf(stderr, "Erro ao alocar entradas.\n"); exit(EXIT_FAILURE); }
+    for (size_t i = 0; i < n; ++i) {
+        char buf[96];
+        snprintf(buf, sizeof(buf), "%s de %s %s %zu",
+                 PALAVRAS[proximoAleatorio() % NUM_PALAVRAS],
+                 PALAVRAS[proximoAleatorio() % NUM_PALAVRAS],
+                 PALAVRAS[proximoAleatorio() % NUM_PALAVRAS], i);
+        v[i] = arenaDuplicaString(a, buf, MEM_TEXTOS);
+    }
+    return v;
+}
+
+typedef uint64_t (*FuncaoHash)(const char *);
+
+/* ns por hash (melhor de 5 rodadas) */
+static double medirHash(FuncaoHash f, char **v, size_t n) {
+    volatile uint64_t sumidouro = 0;
+    double melhor = 1e300;
+    for (int rodada = 0; rodada < 5; ++rodada) {
+        uint64_t acc = 0;
+        double t0 = agoraNs();
+        for (size_t i = 0; i < n; ++i) acc += f(v[i]);
+        double t = (agoraNs() - t0) / (double)n;
+        sumidouro += acc;
+        if (t < melhor) melhor = t;
+    }
+    (void)sumidouro;
+    return melhor;
+}
+
+/* Maior balde em 2^16 baldes, usando bits baixos ou altos do hash */
+static unsigned maiorBalde(FuncaoHash f, char **v, size_t n, int bitsAltos) {
+    unsigned *baldes = (unsigned *)calloc(1u << 16, sizeof(unsigned));
+    unsigned maior = 0;
+    if (!baldes) { fprintf(stderr, "Erro ao alocar baldes.\n"); exit(EXIT_FAILURE); }
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t h = f(v[i]);
+        size_t b = bitsAltos ? (size_t)(h >> 48) : (size_t)(h & 0xFFFF);
+        if (++baldes[b] > maior) maior = baldes[b];
+    }
+    free(baldes);
+    return maior;
+}
+
+/* Contagem antiga: percorre a BST inteira para um único acusado. */
+typedef struct { uint32_t acusado; int total; } ContagemBst;
+
+static void contarNaBst(const PistaNode *n, void *ud) {
+    ContagemBst *c = (ContagemBst *)ud;
+    if (n->suspeito == c->acusado) c->total += n->count;
+}
+
+#define DESCIDAS 1000000
+static volatile uint64_t sumidouroDescidas;
+
+/* Descidas ao acaso (mesma sequência nas duas formas): ns por nível */
+static double descerPonteiros(const Sala *raiz, uint64_t semente, size_t *totalNiveis) {
+    size_t niveis = 0;
+    uint64_t soma = 0;
+    estadoAleatorio = semente;
+    double t0 = agoraNs();
+    for (int d = 0; d < DESCIDAS; ++d) {
+        for (const Sala *s = raiz;; ++niveis) {
+            soma += s->pista;
+            const Sala *f = (proximoAleatorio() & 1) ? s->dir : s->esq;
+            if (!f) f = s->esq ? s->esq : s->dir;
+            if (!f) break;
+            s = f;
+        }
+    }
+    double t = (agoraNs() - t0) / (double)niveis;
+    *totalNiveis = niveis;
+    sumidouroDescidas += soma; /* mantém a leitura das pistas */
+    return t;
+}
+
+static double descerCompacto(const CasoBinario *c, uint64_t semente, size_t *totalNiveis) {
+    size_t niveis = 0;
+    uint64_t soma = 0;
+    estadoAleatorio = semente;
+    double t0 = agoraNs();
+    for (int d = 0; d < DESCIDAS; ++d) {
+        for (uint32_t i = 0;; ++niveis) {
+            soma += c->salas[i].pista;
+            uint32_t f = (proximoAleatorio() & 1) ? casoDir(c, i) : casoEsq(c, i);
+            if (f == CASO_NENHUM) f = (casoEsq(c, i) != CASO_NENHUM) ? casoEsq(c, i) : casoDir(c, i);
+            if (f == CASO_NENHUM) break;
+            i = f;
+        }
+    }
+    double t = (agoraNs() - t0) / (double)niveis;
+    *totalNiveis = niveis;
+    sumidouroDescidas += soma; /* mantém a leitura das pistas */
+    return t;
+}
+
+static void medirFormaCompacta(uint64_t salas) {
+    char spec[64];
+    snprintf(spec, sizeof(spec), "aleatoria:%llu:1", (unsigned long long)salas);
+    ParametrosMansao p;
+    lerParametrosMansao(spec, &p);
+    HashTable *ht = criarHash(p.suspeitos * PISTAS_POR_SUSPEITO * 2);
+    MansaoGerada m = gerarMansao(&p, ht, 1);
+    ordenarInternos();
+
+    double t0 = agoraNs();
+    CasoBinario c;
+    compactarMansao(m.raiz, ht, &c);
+    double tConversao = (agoraNs() - t0) / 1e9;
+
+    FILE *nulo = tmpfile();
+    if (!nulo) { fprintf(stderr, "Erro ao criar arquivo temporario.\n"); exit(EXIT_FAILURE); }
+    size_t niveisP = 0, niveisC = 0;
+    double dPonteiros = descerPonteiros(m.raiz, 42, &niveisP);
+    double dCompacto = descerCompacto(&c, 42, &niveisC);
+    t0 = agoraNs();
+    resolverMansao(m.raiz, ht, NULL, 1, nulo);
+    double rPonteiros = (agoraNs() - t0) / 1e9;
+    t0 = agoraNs();
+    resolverMansao(NULL, NULL, &c, 1, nulo);
+    double rCompacto = (agoraNs() - t0) / 1e9;
+    fclose(nulo);
+    ResumoSuspeitos resumo;
+    t0 = agoraNs();
+    montarResumo(&c, &resumo);
+    double tResumo = (agoraNs() - t0) / 1e9;
+
+    printf("\nmansao aleatoria de %llu salas (conversao para a forma compacta: %.3f s)\n",
+           (unsigned long long)salas, tConversao);
+    printf("%-22s %14s %14s\n", "", "ponteiros", "compacta");
+    printf("%-22s %14zu %14zu\n", "bytes por sala (no)", sizeof(Sala), sizeof(CasoSala));
+    printf("%-22s %14.2f %14.2f\n", "descida (ns/nivel)", dPonteiros, dCompacto);
+    printf("%-22s %14.3f %14.3f\n", "resolvedor (s)", rPonteiros, rCompacto);
+    printf("%-22s %14s %14.3f\n", "resumo p/ --dicas (s)", "-", tResumo);
+    printf("(descidas conferem: %s, %zu niveis)\n", niveisP == niveisC ? "sim" : "NAO", niveisP);
+
+    liberarResumo(&resumo);
+    fecharCaso(&c);
+    liberarMansaoGerada(&m);
+    liberarHash(ht);
+}
+
+static void compararEstruturas(size_t n, uint64_t salas) {
+    Arena arenaEntradas = { NULL, NULL };
+    char **pistas = gerarPistas(&arenaEntradas, n);
+    size_t totalBytes = 0;
+    for (size_t i = 0; i < n; ++i) totalBytes += strlen(pistas[i]);
+
+    printf("Strings: %zu (tamanho medio %.1f bytes)\n\n", n, (double)totalBytes / (double)n);
+    printf("%-12s %10s %16s %16s\n", "hash", "ns/hash", "balde max (baixo)", "balde max (alto)");
+    printf("%-12s %10.2f %16u %16u\n", "djb2", medirHash(djb2Referencia, pistas, n),
+           maiorBalde(djb2Referencia, pistas, n, 0), maiorBalde(djb2Referencia, pistas, n, 1));
+    printf("%-12s %10.2f %16u %16u\n", "hashTexto", medirHash(hashTexto, pistas, n),
+           maiorBalde(hashTexto, pistas, n, 0), maiorBalde(hashTexto, pistas, n, 1));
+    printf("(distribuicao ideal: ~%.0f por balde)\n\n", (double)n / 65536.0);
+
+    /* Consulta na tabela: recalculando o hash x hash em cache x id */
+    HashTable *ht = criarHash(101);
+    uint64_t *hashes = (uint64_t *)malloc(n * sizeof(uint64_t));
+    uint32_t *ids = (uint32_t *)malloc(n * sizeof(uint32_t));
+    if (!hashes || !ids) { fprintf(stderr, "Erro ao alocar hashes.\n"); exit(EXIT_FAILURE); }
+    for (size_t i = 0; i < n; ++i) {
+        inserirNaHash(ht, pistas[i], PALAVRAS[i % NUM_PALAVRAS]);
+        hashes[i] = hashTexto(pistas[i]);
+        ids[i] = buscarInterno(pistas[i]);
+    }
+    size_t achados = 0;
+    double t0 = agoraNs();
+    for (size_t i = 0; i < n; ++i) achados += encontrarSuspeito(ht, pistas[i]) != NULL;
+    double tRecalc = (agoraNs() - t0) / (double)n;
+    t0 = agoraNs();
+    for (size_t i = 0; i < n; ++i) achados += encontrarSuspeitoComHash(ht, pistas[i], hashes[i]) != NULL;
+    double tCache = (agoraNs() - t0) / (double)n;
+    t0 = agoraNs();
+    for (size_t i = 0; i < n; ++i) achados += encontrarSuspeitoId(ht, ids[i]) != ID_NENHUM;
+    double tId = (agoraNs() - t0) / (double)n;
+    printf("encontrarSuspeito         %8.2f ns/consulta\n", tRecalc);
+    printf("encontrarSuspeitoComHash  %8.2f ns/consulta (hash em cache)\n", tCache);
+    printf("encontrarSuspeitoId       %8.2f ns/consulta (pista internada)\n", tId);
+    printf("(%zu consultas resolvidas)\n", achados);
+
+    /* Julgamento: um tabuleiro com todas as pistas, um veredito por suspeito */
+    ordenarInternos();
+    Arena arenaSessao = { NULL, NULL };
+    Evidencias ev;
+    iniciarEvidencias(&arenaSessao, &ev, internos.quantidade);
+    for (size_t i = 0; i < n; ++i) {
+        registrarPista(&arenaSessao, &ev, ids[i], ordemInterna(ids[i]), pistas[i],
+                       encontrarSuspeitoId(ht, ids[i]));
+    }
+    uint32_t acusados[NUM_PALAVRAS];
+    for (size_t k = 0; k < NUM_PALAVRAS; ++k) acusados[k] = buscarInterno(PALAVRAS[k]);
+
+    long somaBst = 0, somaContador = 0;
+    t0 = agoraNs();
+    for (size_t k = 0; k < NUM_PALAVRAS; ++k) {
+        ContagemBst c = { acusados[k], 0 };
+        percorrerInOrder(ev.pistas, contarNaBst, &c);
+        somaBst += c.total;
+    }
+    double tBst = (agoraNs() - t0) / (double)NUM_PALAVRAS;
+    t0 = agoraNs();
+    for (size_t k = 0; k < NUM_PALAVRAS; ++k) somaContador += pistasContra(&ev, acusados[k]);
+    double tContador = (agoraNs() - t0) / (double)NUM_PALAVRAS;
+    uint32_t *ranking = (uint32_t *)malloc(ev.numSuspeitos * sizeof(uint32_t));
+    if (!ranking) { fprintf(stderr, "Erro ao alocar ranking.\n"); exit(EXIT_FAILURE); }
+    t0 = agoraNs();
+    uint32_t numRanking = rankingSuspeitos(&ev, ranking);
+    double tRanking = agoraNs() - t0;
+
+    printf("\nveredito percorrendo BST  %12.0f ns/suspeito\n", tBst);
+    printf("veredito por contador     %12.2f ns/suspeito\n", tContador);
+    printf("ranking completo          %12.0f ns (%u suspeitos; 1o: %s com %d)\n", tRanking, numRanking,
+           numRanking ? textoInterno(ranking[0]) : "-", numRanking ? pistasContra(&ev, ranking[0]) : 0);
+    printf("(totais conferem: %s)\n", somaBst == somaContador ? "sim" : "NAO");
+    free(ranking);
+    arenaLiberar(&arenaSessao);
+
+    liberarHash(ht);
+    liberarInternos();
+
+    medirFormaCompacta(salas);
+    liberarInternos();
+    free(hashes);
+    free(ids);
+    arenaLiberar(&arenaEntradas);
+    free(pistas);
+}
+
+/* ========================== Suíte de operações ========================== */
+
+/* Uma operação medida. preparar() roda fora do cronômetro antes de cada
+   repetição; lote() executa as ops [ini, fim) da repetição e é
+   cronometrado inteiro, um lote de tamLote ops por vez. */
+typedef struct Operacao {
+    const char *caso;
+    const char *distribuicao;
+    size_t escala;
+    size_t opsPorRep;
+    size_t tamLote;
+    int reps;
+    void (*preparar)(void *ctx);
+    void (*lote)(void *ctx, size_t ini, size_t fim);
+    void *ctx;
+} Operacao;
+
+#define OPS_ALVO      2000000    /* ops por caso, divididas em repetições */
+#define REPS_MIN      3
+#define REPS_MAX      50
+#define LOTE_PADRAO   256
+#define CONSULTAS_MIN ((size_t)1 << 16)
+
+static volatile uint64_t sumidouroSuite;
+
+static int repeticoes(size_t opsPorRep) {
+    size_t r = OPS_ALVO / (opsPorRep ? opsPorRep : 1);
+    if (r < REPS_MIN) r = REPS_MIN;
+    if (r > REPS_MAX) r = REPS_MAX;
+    return (int)r;
+}
+
+static int compararDuplos(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* percentil pelo posto mais próximo, sobre amostras já ordenadas */
+static double percentil(const double *v, size_t n, double p) {
+    size_t posto = (size_t)(p / 100.0 * (double)n + 0.999999);
+    if (posto < 1) posto = 1;
+    if (posto > n) posto = n;
+    return v[posto - 1];
+}
+
+static void imprimirCabecalhoSuite(FILE *tsv) {
+    printf("%-18s %-14s %9s %11s %10s %10s %10s %10s %11s\n", "caso", "distribuicao", "escala",
+           "ns/op", "p50", "p90", "p99", "alocs/op", "bytes/op");
+    if (!tsv) return;
+    time_t agora = time(NULL);
+    char data[32];
+    strftime(data, sizeof(data), "%Y-%m-%dT%H:%M:%S", localtime(&agora));
+    fprintf(tsv, "# benchDetetive: suite das estruturas do Capitulo Final (%s)\n", data);
+    fprintf(tsv, "# percentis: ns/op de cada lote cronometrado; alocs/bytes: malloc+calloc+realloc por op\n");
+    fprintf(tsv, "caso\tdistribuicao\tescala\tops\tns_op\tp50_ns\tp90_ns\tp99_ns\tallocs_op\tbytes_op\n");
+}
+
+/* medirOperacao() – roda as repetições, uma amostra por lote, e escreve
+   uma linha na tela e outra no arquivo (se houver). */
+static void medirOperacao(const Operacao *op, FILE *tsv) {
+    size_t lotesPorRep = (op->opsPorRep + op->tamLote - 1) / op->tamLote;
+    size_t numAmostras = lotesPorRep * (size_t)op->reps, k = 0;
+    double *amostras = (double *)malloc(numAmostras * sizeof(double));
+    if (!amostras) { fprintf(stderr, "Erro ao alocar amostras.\n"); exit(EXIT_FAILURE); }
+    double totalNs = 0;
+    unsigned long long totalAlocs = 0, totalBytes = 0, totalOps = 0;
+
+    for (int r = 0; r < op->reps; ++r) {
+        if (op->preparar) op->preparar(op->ctx);
+        for (size_t ini = 0; ini < op->opsPorRep; ini += op->tamLote) {
+            size_t fim = ini + op->tamLote < op->opsPorRep ? ini + op->tamLote : op->opsPorRep;
+            unsigned long long a0 = alocacoes, b0 = bytesAlocados;
+            double t0 = agoraNs();
+            op->lote(op->ctx, ini, fim);
+            double t = agoraNs() - t0;
+            totalAlocs += alocacoes - a0;
+            totalBytes += bytesAlocados - b0;
+            totalNs += t;
+            totalOps += fim - ini;
+            amostras[k++] = t / (double)(fim - ini);
+        }
+    }
+    qsort(amostras, k, sizeof(double), compararDuplos);
+    double nsOp = totalNs / (double)totalOps;
+    double p50 = percentil(amostras, k, 50), p90 = percentil(amostras, k, 90), p99 = percentil(amostras, k, 99);
+    double alocsOp = (double)totalAlocs / (double)totalOps, bytesOp = (double)totalBytes / (double)totalOps;
+
+    printf("%-18s %-14s %9zu %11.2f %10.2f %10.2f %10.2f %10.4f %11.2f\n", op->caso, op->distribuicao,
+           op->escala, nsOp, p50, p90, p99, alocsOp, bytesOp);
+    fflush(stdout);
+    if (tsv) {
+        fprintf(tsv, "%s\t%s\t%zu\t%llu\t%.3f\t%.3f\t%.3f\t%.3f\t%.6f\t%.3f\n", op->caso, op->distribuicao,
+                op->escala, totalOps, nsOp, p50, p90, p99, alocsOp, bytesOp);
+    }
+    free(amostras);
+}
+
+/* Embaralhamento determinístico (Fisher-Yates) */
+static void embaralhar(void **v, size_t n) {
+    for (size_t i = n; i > 1; --i) {
+        size_t j = (size_t)(proximoAleatorio() % i);
+        void *t = v[i - 1];
+        v[i - 1] = v[j];
+        v[j] = t;
+    }
+}
+
+/* ---------------------------- inserirPista ---------------------------- */
+
+typedef struct CtxArvore {
+    Arena sessao;
+    PistaNode *raiz;
+    uint32_t *ordens;            /* chave de cada inserção */
+    size_t visitados;
+} CtxArvore;
+
+typedef enum { CHAVES_ALEATORIAS, CHAVES_CRESCENTES, CHAVES_REPETIDAS } DistribuicaoChaves;
+
+static void iniciarArvore(CtxArvore *c, size_t n, DistribuicaoChaves d) {
+    memset(c, 0, sizeof(*c));
+    c->ordens = (uint32_t *)malloc(n * sizeof(uint32_t));
+    if (!c->ordens) { fprintf(stderr, "Erro ao alocar chaves.\n"); exit(EXIT_FAILURE); }
+    for (size_t i = 0; i < n; ++i) {
+        c->ordens[i] = (d == CHAVES_REPETIDAS) ? (uint32_t)(proximoAleatorio() % 64) : (uint32_t)i;
+    }
+    if (d == CHAVES_ALEATORIAS) {
+        for (size_t i = n; i > 1; --i) {
+            size_t j = (size_t)(proximoAleatorio() % i);
+            uint32_t t = c->ordens[i - 1];
+            c->ordens[i - 1] = c->ordens[j];
+            c->ordens[j] = t;
+        }
+    }
+}
+
+/* cada repetição parte de uma árvore vazia e de uma arena sem blocos */
+static void prepararArvore(void *ctx) {
+    CtxArvore *c = (CtxArvore *)ctx;
+    arenaLiberar(&c->sessao);
+    c->raiz = NULL;
+}
+
+static void loteInserirPista(void *ctx, size_t ini, size_t fim) {
+    CtxArvore *c = (CtxArvore *)ctx;
+    for (size_t i = ini; i < fim; ++i) {
+        inserirPista(&c->sessao, &c->raiz, c->ordens[i], c->ordens[i], "pista", 0);
+    }
+}
+
+static void contarVisita(const PistaNode *n, void *ud) {
+    *(size_t *)ud += (size_t)n->count;
+}
+
+/* um lote = uma travessia completa (fim - ini = nós da árvore) */
+static void lotePercorrer(void *ctx, size_t ini, size_t fim) {
+    CtxArvore *c = (CtxArvore *)ctx;
+    (void)ini; (void)fim;
+    percorrerInOrder(c->raiz, contarVisita, &c->visitados);
+}
+
+static void liberarArvore(CtxArvore *c) {
+    arenaLiberar(&c->sessao);
+    free(c->ordens);
+}
+
+/* --------------------- inserirNaHash / encontrarSuspeito --------------------- */
+
+static const char *SUSPEITOS_BENCH[] = {
+    "Sr. Mostarda", "Srta. Violeta", "Dra. Orquidea", "Professor Carvalho",
+    "Sra. Branca", "Jardineiro", "Coronel Pavao", "Dr. Ameixa",
+};
+
+typedef struct CtxTabela {
+    HashTable *ht;
+    char **pistas;               /* chaves inseridas */
+    size_t numPistas;
+    const char **consultas;      /* sequência de consultas (encontrarSuspeito) */
+    size_t numConsultas;
+    size_t achados;
+    Arena textos;
+} CtxTabela;
+
+/* sequenciais: mesmo prefixo longo, só os dígitos finais mudam */
+static char **gerarPistasSequenciais(Arena *a, size_t n) {
+    char **v = (char **)malloc(n * sizeof(char *));
+    if (!v) { fprintf(stderr, "Erro ao alocar entradas.\n"); exit(EXIT_FAILURE); }
+    for (size_t i = 0; i < n; ++i) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "Pegadas de lama %07zu", i);
+        v[i] = arenaDuplicaString(a, buf, MEM_TEXTOS);
+    }
+    return v;
+}
+
+static void iniciarTabela(CtxTabela *c, size_t n, int sequencial) {
+    memset(c, 0, sizeof(*c));
+    c->numPistas = n;
+    c->pistas = sequencial ? gerarPistasSequenciais(&c->textos, n) : gerarPistas(&c->textos, n);
+    if (!sequencial) embaralhar((void **)c->pistas, n);
+}
+
+/* tabela e internação novas a cada repetição */
+static void prepararTabela(void *ctx) {
+    CtxTabela *c = (CtxTabela *)ctx;
+    liberarHash(c->ht);
+    liberarInternos();
+    c->ht = criarHash(101);
+}
+
+static void loteInserirNaHash(void *ctx, size_t ini, size_t fim) {
+    CtxTabela *c = (CtxTabela *)ctx;
+    for (size_t i = ini; i < fim; ++i) {
+        inserirNaHash(c->ht, c->pistas[i], SUSPEITOS_BENCH[i % NUM_DE(SUSPEITOS_BENCH)]);
+    }
+}
+
+typedef enum { CONSULTA_UNIFORME, CONSULTA_CONCENTRADA, CONSULTA_AUSENTE } DistribuicaoConsultas;
+
+/* tabela cheia com as n pistas e uma sequência fixa de consultas */
+static void iniciarConsultas(CtxTabela *c, size_t n, DistribuicaoConsultas d) {
+    iniciarTabela(c, n, 0);
+    prepararTabela(c);
+    loteInserirNaHash(c, 0, n);
+    size_t quentes = n / 100 ? n / 100 : 1;
+    c->numConsultas = n > CONSULTAS_MIN ? n : CONSULTAS_MIN;
+    c->consultas = (const char **)malloc(c->numConsultas * sizeof(char *));
+    if (!c->consultas) { fprintf(stderr, "Erro ao alocar consultas.\n"); exit(EXIT_FAILURE); }
+    for (size_t i = 0; i < c->numConsultas; ++i) {
+        if (d == CONSULTA_AUSENTE) {
+            char buf[48];
+            snprintf(buf, sizeof(buf), "Pista inexistente %zu", i);
+            c->consultas[i] = arenaDuplicaString(&c->textos, buf, MEM_TEXTOS);
+        } else if (d == CONSULTA_CONCENTRADA && proximoAleatorio() % 10 != 0) {
+            c->consultas[i] = c->pistas[proximoAleatorio() % quentes];
+        } else {
+            c->consultas[i] = c->pistas[proximoAleatorio() % n];
+        }
+    }
+}
+
+static void loteEncontrarSuspeito(void *ctx, size_t ini, size_t fim) {
+    CtxTabela *c = (CtxTabela *)ctx;
+    size_t achados = 0;
+    for (size_t i = ini; i < fim; ++i) {
+        achados += encontrarSuspeito(c->ht, c->consultas[i % c->numConsultas]) != NULL;
+    }
+    c->achados += achados;
+}
+
+static void liberarTabela(CtxTabela *c) {
+    liberarHash(c->ht);
+    liberarInternos();
+    free(c->pistas);
+    free((void *)c->consultas);
+    arenaLiberar(&c->textos);
+}
+
+/* ----------------------------- pistaDaSala ----------------------------- */
+
+typedef struct CtxSalas {
+    const char *nomes[NUM_PISTAS_POR_SALA];
+    size_t numNomes;
+    size_t achadas;
+} CtxSalas;
+
+static void lotePistaDaSala(void *ctx, size_t ini, size_t fim) {
+    CtxSalas *c = (CtxSalas *)ctx;
+    size_t achadas = 0;
+    for (size_t i = ini; i < fim; ++i) achadas += pistaDaSala(c->nomes[i % c->numNomes]) != NULL;
+    c->achadas += achadas;
+}
+
+/* ----------------------- veredito e ranking ----------------------- */
+
+typedef struct CtxVeredito {
+    Arena sessao;
+    Evidencias ev;
+    char **suspeitos;
+    uint32_t numSuspeitos;
+    uint32_t *ranking;
+    long soma;
+    Arena textos;
+} CtxVeredito;
+
+/* tabuleiro com n pistas coletadas, espalhadas entre S suspeitos */
+static void iniciarVeredito(CtxVeredito *c, size_t n, uint32_t numSuspeitos) {
+    memset(c, 0, sizeof(*c));
+    c->numSuspeitos = numSuspeitos;
+    c->suspeitos = (char **)malloc(numSuspeitos * sizeof(char *));
+    char **pistas = gerarPistas(&c->textos, n);
+    uint32_t *idsPistas = (uint32_t *)malloc(n * sizeof(uint32_t));
+    uint32_t *idsSuspeitos = (uint32_t *)malloc(numSuspeitos * sizeof(uint32_t));
+    if (!c->suspeitos || !idsPistas || !idsSuspeitos) {
+        fprintf(stderr, "Erro ao alocar tabuleiro.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t s = 0; s < numSuspeitos; ++s) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%s %u", SUSPEITOS_BENCH[s % NUM_DE(SUSPEITOS_BENCH)], s);
+        c->suspeitos[s] = arenaDuplicaString(&c->textos, buf, MEM_TEXTOS);
+        idsSuspeitos[s] = internar(buf);
+    }
+    for (size_t i = 0; i < n; ++i) idsPistas[i] = internar(pistas[i]);
+    ordenarInternos();
+    iniciarEvidencias(&c->sessao, &c->ev, internos.quantidade);
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t s = (uint32_t)(proximoAleatorio() % numSuspeitos);
+        registrarPista(&c->sessao, &c->ev, idsPistas[i], ordemInterna(idsPistas[i]), pistas[i], idsSuspeitos[s]);
+    }
+    c->ranking = (uint32_t *)malloc(c->ev.numSuspeitos * sizeof(uint32_t));
+    if (!c->ranking) { fprintf(stderr, "Erro ao alocar ranking.\n"); exit(EXIT_FAILURE); }
+    free(idsSuspeitos);
+    free(idsPistas);
+    free(pistas);
+}
+
+static void loteVeredito(void *ctx, size_t ini, size_t fim) {
+    CtxVeredito *c = (CtxVeredito *)ctx;
+    long soma = 0;
+    for (size_t i = ini; i < fim; ++i) soma += julgarSuspeito(&c->ev, NULL, c->suspeitos[i % c->numSuspeitos]);
+    c->soma += soma;
+}
+
+static void loteRanking(void *ctx, size_t ini, size_t fim) {
+    CtxVeredito *c = (CtxVeredito *)ctx;
+    for (size_t i = ini; i < fim; ++i) c->soma += rankingSuspeitos(&c->ev, c->ranking);
+}
+
+static void liberarVeredito(CtxVeredito *c) {
+    free(c->ranking);
+    free(c->suspeitos);
+    arenaLiberar(&c->sessao);
+    arenaLiberar(&c->textos);
+    liberarInternos();
+}
+
+/* ------------------ montagem e liberação do mapa ------------------ */
+
+#define SALAS_EMBUTIDAS 11
+
+/* op = uma sala: cada mansão embutida conta 11 */
+static void loteMapaEmbutido(void *ctx, size_t ini, size_t fim) {
+    (void)ctx;
+    for (size_t i = ini; i < fim; i += SALAS_EMBUTIDAS) {
+        Arena a = { NULL, NULL };
+        HashTable *ht = criarHash(101);
+        Sala *raiz = montarMapa(&a);
+        popularMapaPistas(ht);
+        ordenarInternos();
+        sumidouroSuite += raiz->pista;
+        liberarHash(ht);
+        liberarInternos();
+        arenaLiberar(&a);
+    }
+}
+
+typedef struct CtxMansao {
+    ParametrosMansao p;
+    MansaoGerada m;
+    HashTable *ht;
+} CtxMansao;
+
+/* um lote = uma mansão inteira: gerar, registrar pistas e liberar */
+static void loteGerarMansao(void *ctx, size_t ini, size_t fim) {
+    CtxMansao *c = (CtxMansao *)ctx;
+    (void)ini; (void)fim;
+    HashTable *ht = criarHash(c->p.suspeitos * PISTAS_POR_SUSPEITO * 2);
+    MansaoGerada m = gerarMansao(&c->p, ht, 1);
+    sumidouroSuite += m.raiz->pista;
+    liberarMansaoGerada(&m);
+    liberarHash(ht);
+    liberarInternos();
+}
+
+/* um lote = a conversão da mansão inteira para a forma compacta */
+static void loteCompactar(void *ctx, size_t ini, size_t fim) {
+    CtxMansao *c = (CtxMansao *)ctx;
+    CasoBinario caso;
+    (void)ini; (void)fim;
+    compactarMansao(c->m.raiz, c->ht, &caso);
+    sumidouroSuite += caso.numSalas;
+    fecharCaso(&caso);
+}
+
+/* gerarMansao e o resolvedor contam o tempo em stderr: na suíte, a cada
+   repetição, isso só polui a tabela. */
+static int stderrGuardado = -1;
+
+static void silenciarStderr(void) {
+#ifndef _WIN32
+    fflush(stderr);
+    int nulo = open("/dev/null", O_WRONLY);
+    if (nulo < 0) return;
+    stderrGuardado = dup(STDERR_FILENO);
+    dup2(nulo, STDERR_FILENO);
+    close(nulo);
+#endif
+}
+
+static void restaurarStderr(void) {
+#ifndef _WIN32
+    if (stderrGuardado < 0) return;
+    fflush(stderr);
+    dup2(stderrGuardado, STDERR_FILENO);
+    close(stderrGuardado);
+    stderrGuardado = -1;
+#endif
+}
+
+/* ------------------------------ a suíte ------------------------------ */
+
+static const size_t ESCALAS[] = { 1000, 10000, 100000, 1000000 };
+
+static void executarSuite(size_t numEscalas, FILE *tsv) {
+    imprimirCabecalhoSuite(tsv);
+
+    static const char *NOMES_CHAVES[] = { "aleatoria", "crescente", "repetida" };
+    for (int d = 0; d < 3; ++d) {
+        for (size_t e = 0; e < numEscalas; ++e) {
+            CtxArvore c;
+            estadoAleatorio = 0x2545F4914F6CDD1Dull;
+            iniciarArvore(&c, ESCALAS[e], (DistribuicaoChaves)d);
+            size_t tam = ESCALAS[e] < LOTE_PADRAO ? ESCALAS[e] : LOTE_PADRAO;
+            Operacao op = { "inserirPista", NOMES_CHAVES[d], ESCALAS[e], ESCALAS[e], tam,
+                            repeticoes(ESCALAS[e]), prepararArvore, loteInserirPista, &c };
+            medirOperacao(&op, tsv);
+            liberarArvore(&c);
+        }
+    }
+
+    for (size_t e = 0; e < numEscalas; ++e) {
+        CtxArvore c;
+        estadoAleatorio = 0x2545F4914F6CDD1Dull;
+        iniciarArvore(&c, ESCALAS[e], CHAVES_ALEATORIAS);
+        loteInserirPista(&c, 0, ESCALAS[e]);
+        Operacao op = { "percorrerInOrder", "aleatoria", ESCALAS[e], 8 * ESCALAS[e], ESCALAS[e],
+                        repeticoes(8 * ESCALAS[e]), NULL, lotePercorrer, &c };
+        medirOperacao(&op, tsv);
+        liberarArvore(&c);
+    }
+
+    static const char *NOMES_TABELA[] = { "aleatoria", "sequencial" };
+    for (int d = 0; d < 2; ++d) {
+        for (size_t e = 0; e < numEscalas; ++e) {
+            CtxTabela c;
+            estadoAleatorio = 0x2545F4914F6CDD1Dull;
+            iniciarTabela(&c, ESCALAS[e], d);
+            Operacao op = { "inserirNaHash", NOMES_TABELA[d], ESCALAS[e], ESCALAS[e], LOTE_PADRAO,
+                            repeticoes(ESCALAS[e]), prepararTabela, loteInserirNaHash, &c };
+            medirOperacao(&op, tsv);
+            liberarTabela(&c);
+        }
+    }
+
+    static const char *NOMES_CONSULTAS[] = { "uniforme", "concentrada", "ausente" };
+    for (int d = 0; d < 3; ++d) {
+        for (size_t e = 0; e < numEscalas; ++e) {
+            CtxTabela c;
+            estadoAleatorio = 0x2545F4914F6CDD1Dull;
+            iniciarConsultas(&c, ESCALAS[e], (DistribuicaoConsultas)d);
+            Operacao op = { "encontrarSuspeito", NOMES_CONSULTAS[d], ESCALAS[e], c.numConsultas, LOTE_PADRAO,
+                            repeticoes(c.numConsultas), NULL, loteEncontrarSuspeito, &c };
+            medirOperacao(&op, tsv);
+            liberarTabela(&c);
+        }
+    }
+
+    /* a tabela fixa tem NUM_PISTAS_POR_SALA salas; as ausentes são os
+       tipos do gerador que não estão nela */
+    for (int d = 0; d < 2; ++d) {
+        CtxSalas c;
+        memset(&c, 0, sizeof(c));
+        for (size_t i = 0; i < NUM_DE(TIPOS_SALA) && c.numNomes < NUM_PISTAS_POR_SALA; ++i) {
+            int naTabela = 0;
+            for (size_t k = 0; k < NUM_PISTAS_POR_SALA; ++k) {
+                naTabela |= strcmp(PISTAS_POR_SALA[k].sala, TIPOS_SALA[i]) == 0;
+            }
+            if (naTabela != (d == 0)) continue;
+            c.nomes[c.numNomes++] = TIPOS_SALA[i];
+        }
+        Operacao op = { "pistaDaSala", d == 0 ? "existente" : "ausente", NUM_PISTAS_POR_SALA, CONSULTAS_MIN,
+                        LOTE_PADRAO, repeticoes(CONSULTAS_MIN), NULL, lotePistaDaSala, &c };
+        medirOperacao(&op, tsv);
+    }
+
+    static const uint32_t NUM_SUSPEITOS[] = { 8, 1024 };
+    static const char *NOMES_SUSPEITOS[] = { "suspeitos=8", "suspeitos=1024" };
+    for (int d = 0; d < 2; ++d) {
+        for (size_t e = 0; e < numEscalas; ++e) {
+            CtxVeredito c;
+            estadoAleatorio = 0x2545F4914F6CDD1Dull;
+            iniciarVeredito(&c, ESCALAS[e], NUM_SUSPEITOS[d]);
+            Operacao op = { "veredito", NOMES_SUSPEITOS[d], ESCALAS[e], CONSULTAS_MIN, LOTE_PADRAO,
+                            repeticoes(CONSULTAS_MIN), NULL, loteVeredito, &c };
+            medirOperacao(&op, tsv);
+            /* o ranking varre todos os ids internados: poucas ops por lote */
+            size_t rankings = CONSULTAS_MIN / ESCALAS[e] ? CONSULTAS_MIN / ESCALAS[e] : 1;
+            Operacao ranking = { "rankingSuspeitos", NOMES_SUSPEITOS[d], ESCALAS[e], 4 * rankings, rankings,
+                                 REPS_MIN, NULL, loteRanking, &c };
+            medirOperacao(&ranking, tsv);
+            liberarVeredito(&c);
+        }
+    }
+
+    Operacao embutida = { "montarMapa", "embutida", SALAS_EMBUTIDAS, SALAS_EMBUTIDAS * 256,
+                          SALAS_EMBUTIDAS * 16, repeticoes(SALAS_EMBUTIDAS * 256), NULL, loteMapaEmbutido, NULL };
+    medirOperacao(&embutida, tsv);
+
+    static const char *FORMAS[] = { "balanceada", "degenerada", "aleatoria" };
+    silenciarStderr();
+    for (int f = 0; f < 3; ++f) {
+        for (size_t e = 0; e < numEscalas; ++e) {
+            CtxMansao c;
+            char spec[64];
+            snprintf(spec, sizeof(spec), "%s:%zu:1", FORMAS[f], ESCALAS[e]);
+            lerParametrosMansao(spec, &c.p);
+            Operacao op = { "gerarMansao", FORMAS[f], ESCALAS[e], ESCALAS[e], ESCALAS[e],
+                            repeticoes(ESCALAS[e]), NULL, loteGerarMansao, &c };
+            medirOperacao(&op, tsv);
+        }
+    }
+    for (size_t e = 0; e < numEscalas; ++e) {
+        CtxMansao c;
+        char spec[64];
+        snprintf(spec, sizeof(spec), "aleatoria:%zu:1", ESCALAS[e]);
+        lerParametrosMansao(spec, &c.p);
+        c.ht = criarHash(c.p.suspeitos * PISTAS_POR_SUSPEITO * 2);
+        c.m = gerarMansao(&c.p, c.ht, 1);
+        ordenarInternos();
+        Operacao op = { "compactarMansao", "aleatoria", ESCALAS[e], ESCALAS[e], ESCALAS[e],
+                        repeticoes(ESCALAS[e]), NULL, loteCompactar, &c };
+        medirOperacao(&op, tsv);
+        liberarMansaoGerada(&c.m);
+        liberarHash(c.ht);
+        liberarInternos();
+    }
+    restaurarStderr();
+}
+
+static void usoBench(const char *prog) {
+    fprintf(stderr, "Uso: %s [--rapido] [--saida arquivo]\n"
+                    "     %s --comparar [quantidade_de_strings] [salas]\n", prog, prog);
+}
+
+int main(int argc, char **argv) {
+    const char *arquivoSaida = "bench_output.txt";
+    int rapido = 0, comparar = 0, posicionais = 0;
+    size_t n = 1000000;
+    uint64_t salas = 2000000;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--rapido") == 0) {
+            rapido = 1;
+        } else if (strcmp(argv[i], "--saida") == 0 && i + 1 < argc) {
+            arquivoSaida = argv[++i];
+        } else if (strcmp(argv[i], "--comparar") == 0) {
+            comparar = 1;
+        } else if (isdigit((unsigned char)argv[i][0]) && posicionais < 2) {
+            /* números soltos: as comparações, como nas versões anteriores */
+            comparar = 1;
+            if (posicionais++ == 0) n = (size_t)strtoull(argv[i], NULL, 10);
+            else                    salas = strtoull(argv[i], NULL, 10);
+        } else {
+            usoBench(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (comparar) {
+        compararEstruturas(n ? n : 1, salas ? salas : 1);
+        return 0;
+    }
+
+    FILE *tsv = fopen(arquivoSaida, "w");
+    if (!tsv) {
+        perror(arquivoSaida);
+        return EXIT_FAILURE;
+    }
+    executarSuite(rapido ? 2 : NUM_DE(ESCALAS), tsv);
+    fclose(tsv);
+    printf("(resultados em %s)\n", arquivoSaida);
+    return 0;
+}
@@ -0,0 +1,440 @@
+#define _DEFAULT_SOURCE          /* fork, pipe, poll, wait4 (POSIX/BSD) */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+/* ============================================================
+   Detective Quest - Carga de latência ponta a ponta
+   ------------------------------------------------------------
+   Sobe várias instâncias dos programas dos capítulos (os binários
+   de verdade), cada uma com stdin e stdout em pipes, e joga por
+   elas como um jogador: lê a saída até o próximo prompt, escolhe o
+   comando pelo prompt e o envia num ritmo controlado. Mede, por
+   programa e por tipo de comando, o tempo entre o envio e o prompt
+   seguinte – lerOpcao(), a atualização da sala e os printf, pelo
+   mesmo caminho de E/S que o jogador usa – e o pico de memória
+   residente de cada processo (wait4).
+
+   Compilação:  gcc -O2 -o cargaLatencia A5_cargaLatencia.c   (POSIX)
+   Execução:    ./cargaLatencia [opções] [programa ...]
+       programa           linha de comando de um capítulo, entre aspas
+                          se tiver argumentos ("./detetiveMestre --compacto");
+                          padrão: ./detetiveNovato ./detetiveAventureiro
+                          ./detetiveMestre
+       --instancias N     processos simultâneos por programa (8)
+       --sessoes N        explorações por processo (20)
+       --taxa R           comandos por segundo por processo (200; 0 = sem
+                          pausa, cada comando sai assim que o prompt chega)
+       --semente S        escolhas e/d determinísticas (1)
+       --saida arquivo    resultados separados por tabulações
+                          (latencia_output.txt)
+
+   Prompts: todo prompt dos capítulos termina em ": " sem quebra de
+   linha, e os capítulos descarregam stdout antes de ler; a resposta a
+   um comando é tudo o que chega até o próximo prompt. Comandos:
+       "Opcao: "          "1" até completar as sessões, depois "0";
+       "[e/d/s]: "        'e' ou 'd' ao acaso; 's' em 1 de cada 8 (nos
+                          capítulos que não param na folha) ou após 64;
+       outro prompt       nome de um suspeito (acusação do Mestre).
+   A primeira resposta (do exec até o menu) conta como "partida".
+
+   Com --taxa, cada comando tem horário marcado e a latência conta a
+   partir dele, não do envio: se o processo (ou a própria carga)
+   atrasa, o atraso entra na medida em vez de empurrar os envios
+   seguintes (sem omissão coordenada).
+   ============================================================ */
+
+#define MAX_PROGRAMAS     8
+#define MAX_ARGS          16
+#define MAX_INSTANCIAS    256
+#define MAX_MOVIMENTOS    64
+#define TAM_CAUDA         48
+
+typedef enum { CMD_PARTIDA, CMD_MENU, CMD_MOVIMENTO, CMD_ACUSACAO, NUM_TIPOS } TipoComando;
+
+static const char *NOMES_TIPOS[NUM_TIPOS] = { "partida", "menu", "movimento", "acusacao" };
+
+static const char *ACUSADOS[] = {
+    "Jardineiro", "Srta. Violeta", "Sr. Mostarda", "Sra. Branca", "Professor Carvalho", "Dra. Orquidea",
+};
+#define NUM_ACUSADOS (sizeof(ACUSADOS) / sizeof(ACUSADOS[0]))
+
+/* Latências de um tipo de comando (ns), em vetor crescente */
+typedef struct Amostras {
+    double *v;
+    size_t n, cap;
+} Amostras;
+
+typedef struct Programa {
+    const char *linha;           /* como veio na linha de comando */
+    char *copia;                 /* linha picada em argv[] */
+    char *argv[MAX_ARGS + 1];
+    Amostras lat[NUM_TIPOS];
+    long rssMaxKb;               /* maior pico entre as instâncias */
+    double rssSomaKb;
+    int encerradas;
+    int falhas;                  /* saída com status != 0 ou por sinal */
+} Programa;
+
+typedef struct Instancia {
+    Programa *prog;
+    pid_t pid;
+    int entrada;                 /* escrita -> stdin do processo */
+    int saida;                   /* leitura <- stdout do processo */
+    char cauda[TAM_CAUDA];       /* últimos bytes recebidos */
+    size_t tamCauda;
+    int aguardando;              /* comando enviado, esperando o prompt */
+    TipoComando tipo;            /* do comando em curso */
+    double marcado;              /* início da medida do comando em curso */
+    double proximoEnvio;         /* horário marcado do comando pendente */
+    char pendente[64];           /* próximo comando (com '\n') */
+    TipoComando tipoPendente;
+    int sessoes, movimentos;
+    uint64_t aleatorio;
+} Instancia;
+
+static double agoraNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* xorshift64*: escolhas reproduzíveis por semente */
+static uint64_t proximoAleatorio(uint64_t *estado) {
+    *estado ^= *estado >> 12;
+    *estado ^= *estado << 25;
+    *estado ^= *estado >> 27;
+    return *estado * 0x2545F4914F6CDD1Dull;
+}
+
+static void adicionarAmostra(Amostras *a, double ns) {
+    if (a->n == a->cap) {
+        size_t cap = a->cap ? a->cap * 2 : 1024;
+        double *v = (double *)realloc(a->v, cap * sizeof(double));
+        if (!v) {
+            fprintf(stderr, "Erro ao alocar amostras.\n");
+            exit(EXIT_FAILURE);
+        }
+        a->v = v;
+        a->cap = cap;
+    }
+    a->v[a->n++] = ns;
+}
+
+static int compararDuplos(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* percentil pelo posto mais próximo, sobre amostras já ordenadas */
+static double percentil(const double *v, size_t n, double p) {
+    size_t posto = (size_t)(p / 100.0 * (double)n + 0.999999);
+    if (posto < 1) posto = 1;
+    if (posto > n) posto = n;
+    return v[posto - 1];
+}
+
+/* Pica a linha do programa em palavras (separadas por espaços). */
+static int prepararPrograma(Programa *p, const char *linha) {
+    memset(p, 0, sizeof(*p));
+    p->linha = linha;
+    p->copia = (char *)malloc(strlen(linha) + 1);
+    if (!p->copia) return -1;
+    strcpy(p->copia, linha);
+    int n = 0;
+    for (char *tok = strtok(p->copia, " \t"); tok; tok = strtok(NULL, " \t")) {
+        if (n == MAX_ARGS) return -1;
+        p->argv[n++] = tok;
+    }
+    p->argv[n] = NULL;
+    return n ? 0 : -1;
+}
+
+static void marcarFechoNoExec(int fd) {
+    fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC);
+}
+
+/* iniciarInstancia() – fork + exec com stdin/stdout em pipes. */
+static int iniciarInstancia(Instancia *in, Programa *p, uint64_t semente) {
+    int paraFilho[2], doFilho[2];
+    if (pipe(paraFilho) != 0) return -1;
+    if (pipe(doFilho) != 0) {
+        close(paraFilho[0]);
+        close(paraFilho[1]);
+        return -1;
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(paraFilho[0]); close(paraFilho[1]);
+        close(doFilho[0]);   close(doFilho[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        dup2(paraFilho[0], STDIN_FILENO);
+        dup2(doFilho[1], STDOUT_FILENO);
+        close(paraFilho[0]); close(paraFilho[1]);
+        close(doFilho[0]);   close(doFilho[1]);
+        execvp(p->argv[0], p->argv);
+        fprintf(stderr, "%s: %s\n", p->argv[0], strerror(errno));
+        _exit(127);
+    }
+    close(paraFilho[0]);
+    close(doFilho[1]);
+    marcarFechoNoExec(paraFilho[1]);
+    marcarFechoNoExec(doFilho[0]);
+
+    memset(in, 0, sizeof(*in));
+    in->prog = p;
+    in->pid = pid;
+    in->entrada = paraFilho[1];
+    in->saida = doFilho[0];
+    in->aguardando = 1;
+    in->tipo = CMD_PARTIDA;
+    in->marcado = agoraNs();
+    in->aleatorio = semente ? semente : 1;
+    return 0;
+}
+
+static int terminaCom(const Instancia *in, const char *sufixo) {
+    size_t n = strlen(sufixo);
+    return in->tamCauda >= n && memcmp(in->cauda + in->tamCauda - n, sufixo, n) == 0;
+}
+
+/* Guarda só o fim do que chegou: basta para reconhecer o prompt. */
+static void acumularCauda(Instancia *in, const char *buf, size_t n) {
+    if (n >= TAM_CAUDA) {
+        memcpy(in->cauda, buf + n - TAM_CAUDA, TAM_CAUDA);
+        in->tamCauda = TAM_CAUDA;
+        return;
+    }
+    size_t manter = in->tamCauda + n > TAM_CAUDA ? TAM_CAUDA - n : in->tamCauda;
+    memmove(in->cauda, in->cauda + in->tamCauda - manter, manter);
+    memcpy(in->cauda + manter, buf, n);
+    in->tamCauda = manter + n;
+}
+
+/* escolherComando() – o que um jogador digitaria neste prompt. */
+static void escolherComando(Instancia *in, int sessoesPorInstancia) {
+    if (terminaCom(in, "Opcao: ")) {
+        in->tipoPendente = CMD_MENU;
+        if (in->sessoes < sessoesPorInstancia) {
+            in->sessoes++;
+            in->movimentos = 0;
+            strcpy(in->pendente, "1\n");
+        } else {
+            strcpy(in->pendente, "0\n");
+        }
+    } else if (terminaCom(in, "[e/d/s]: ")) {
+        in->tipoPendente = CMD_MOVIMENTO;
+        uint64_t sorteio = proximoAleatorio(&in->aleatorio);
+        if (++in->movimentos > MAX_MOVIMENTOS || sorteio % 8 == 0) strcpy(in->pendente, "s\n");
+        else strcpy(in->pendente, (sorteio >> 32) & 1 ? "d\n" : "e\n");
+    } else {
+        in->tipoPendente = CMD_ACUSACAO;
+        snprintf(in->pendente, sizeof(in->pendente), "%s\n",
+                 ACUSADOS[proximoAleatorio(&in->aleatorio) % NUM_ACUSADOS]);
+    }
+}
+
+/* encerrarInstancia() – recolhe o processo e o pico de memória dele. */
+static void encerrarInstancia(Instancia *in) {
+    close(in->entrada);
+    close(in->saida);
+    int status = 0;
+    struct rusage uso;
+    memset(&uso, 0, sizeof(uso));
+    while (wait4(in->pid, &status, 0, &uso) < 0 && errno == EINTR) {}
+    Programa *p = in->prog;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) p->falhas++;
+    if (uso.ru_maxrss > p->rssMaxKb) p->rssMaxKb = uso.ru_maxrss;
+    p->rssSomaKb += (double)uso.ru_maxrss;
+    p->encerradas++;
+    in->pid = 0;
+}
+
+static void enviarPendente(Instancia *in, double agora, double intervalo) {
+    size_t n = strlen(in->pendente);
+    /* com ritmo, a medida parte do horário marcado (ver o cabeçalho) */
+    in->marcado = intervalo > 0 ? in->proximoEnvio : agora;
+    in->tipo = in->tipoPendente;
+    in->aguardando = 1;
+    in->tamCauda = 0;
+    if (write(in->entrada, in->pendente, n) != (ssize_t)n) {
+        /* processo já saiu: o EOF na leitura encerra a instância */
+        in->tipo = NUM_TIPOS;
+    }
+}
+
+/* Lê o que estiver disponível; devolve 0 no fim da saída do processo. */
+static int receber(Instancia *in, double intervalo, int sessoesPorInstancia) {
+    char buf[1 << 16];
+    ssize_t n = read(in->saida, buf, sizeof(buf));
+    if (n < 0) return errno == EINTR || errno == EAGAIN;
+    if (n == 0) return 0;
+    acumularCauda(in, buf, (size_t)n);
+    if (!in->aguardando || !terminaCom(in, ": ")) return 1;
+
+    double agora = agoraNs();
+    if (in->tipo < NUM_TIPOS) adicionarAmostra(&in->prog->lat[in->tipo], agora - in->marcado);
+    in->aguardando = 0;
+    escolherComando(in, sessoesPorInstancia);
+    in->proximoEnvio = intervalo > 0 ? in->marcado + intervalo : agora;
+    return 1;
+}
+
+static void usoCarga(const char *prog) {
+    fprintf(stderr, "Uso: %s [--instancias N] [--sessoes N] [--taxa comandos/s] [--semente S]"
+                    " [--saida arquivo] [programa ...]\n", prog);
+}
+
+int main(int argc, char **argv) {
+    int instancias = 8, sessoes = 20;
+    double taxa = 200;
+    uint64_t semente = 1;
+    const char *arquivoSaida = "latencia_output.txt";
+    const char *linhas[MAX_PROGRAMAS];
+    int numProgramas = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--instancias") == 0 && i + 1 < argc) {
+            instancias = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--sessoes") == 0 && i + 1 < argc) {
+            sessoes = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--taxa") == 0 && i + 1 < argc) {
+            taxa = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc) {
+            semente = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--saida") == 0 && i + 1 < argc) {
+            arquivoSaida = argv[++i];
+        } else if (argv[i][0] != '-' && numProgramas < MAX_PROGRAMAS) {
+            linhas[numProgramas++] = argv[i];
+        } else {
+            usoCarga(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (numProgramas == 0) {
+        linhas[numProgramas++] = "./detetiveNovato";
+        linhas[numProgramas++] = "./detetiveAventureiro";
+        linhas[numProgramas++] = "./detetiveMestre";
+    }
+    if (instancias < 1) instancias = 1;
+    if (instancias * numProgramas > MAX_INSTANCIAS) instancias = MAX_INSTANCIAS / numProgramas;
+    if (sessoes < 1) sessoes = 1;
+    double intervalo = taxa > 0 ? 1e9 / taxa : 0;
+
+    signal(SIGPIPE, SIG_IGN); /* escrita para um processo que já saiu */
+
+    Programa programas[MAX_PROGRAMAS];
+    static Instancia inst[MAX_INSTANCIAS];
+    struct pollfd fds[MAX_INSTANCIAS];
+    int numInst = 0, vivas = 0;
+    double t0 = agoraNs();
+    for (int p = 0; p < numProgramas; ++p) {
+        if (prepararPrograma(&programas[p], linhas[p]) != 0) {
+            fprintf(stderr, "Erro: programa invalido: \"%s\".\n", linhas[p]);
+            return EXIT_FAILURE;
+        }
+        for (int k = 0; k < instancias; ++k) {
+            if (iniciarInstancia(&inst[numInst], &programas[p], semente + (uint64_t)numInst) != 0) {
+                perror("fork/pipe");
+                return EXIT_FAILURE;
+            }
+            numInst++;
+            vivas++;
+        }
+    }
+
+    /* laço de eventos: espera saída de qualquer instância ou o próximo
+       horário marcado, o que vier antes */
+    while (vivas > 0) {
+        double agora = agoraNs(), proximo = -1;
+        for (int i = 0; i < numInst; ++i) {
+            Instancia *in = &inst[i];
+            if (!in->pid || in->aguardando) continue;
+            if (in->proximoEnvio <= agora) enviarPendente(in, agora, intervalo);
+            else if (proximo < 0 || in->proximoEnvio < proximo) proximo = in->proximoEnvio;
+        }
+
+        int numFds = 0, quem[MAX_INSTANCIAS];
+        for (int i = 0; i < numInst; ++i) {
+            if (!inst[i].pid) continue;
+            fds[numFds].fd = inst[i].saida;
+            fds[numFds].events = POLLIN;
+            fds[numFds].revents = 0;
+            quem[numFds++] = i;
+        }
+        int espera = -1;
+        if (proximo >= 0) {
+            double ms = (proximo - agoraNs()) / 1e6;
+            espera = ms <= 0 ? 0 : (int)ms + 1;
+        }
+        int prontos = poll(fds, (nfds_t)numFds, espera);
+        if (prontos < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            return EXIT_FAILURE;
+        }
+        for (int f = 0; f < numFds && prontos > 0; ++f) {
+            if (!fds[f].revents) continue;
+            --prontos;
+            Instancia *in = &inst[quem[f]];
+            if (!receber(in, intervalo, sessoes)) {
+                encerrarInstancia(in);
+                vivas--;
+            }
+        }
+    }
+    double total = (agoraNs() - t0) / 1e9;
+
+    FILE *tsv = fopen(arquivoSaida, "w");
+    if (!tsv) perror(arquivoSaida);
+    else {
+        fprintf(tsv, "# cargaLatencia: %d instancias x %d sessoes por programa, taxa %.0f cmd/s (0 = livre)\n",
+                instancias, sessoes, taxa);
+        fprintf(tsv, "programa\tcomando\tamostras\tp50_us\tp99_us\tp999_us\tmax_us\trss_max_kb\trss_medio_kb\n");
+    }
+    printf("%d instancias x %d sessoes por programa em %.2f s (taxa %.0f cmd/s por instancia)\n\n",
+           instancias, sessoes, total, taxa);
+    printf("%-28s %-10s %9s %10s %10s %10s %10s\n", "programa", "comando", "amostras",
+           "p50 (us)", "p99 (us)", "p999 (us)", "max (us)");
+    int falhas = 0;
+    for (int p = 0; p < numProgramas; ++p) {
+        Programa *pr = &programas[p];
+        double rssMedio = pr->encerradas ? pr->rssSomaKb / pr->encerradas : 0;
+        for (int t = 0; t < NUM_TIPOS; ++t) {
+            Amostras *a = &pr->lat[t];
+            if (!a->n) continue;
+            qsort(a->v, a->n, sizeof(double), compararDuplos);
+            double p50 = percentil(a->v, a->n, 50) / 1e3, p99 = percentil(a->v, a->n, 99) / 1e3;
+            double p999 = percentil(a->v, a->n, 99.9) / 1e3, max = a->v[a->n - 1] / 1e3;
+            printf("%-28s %-10s %9zu %10.1f %10.1f %10.1f %10.1f\n", pr->linha, NOMES_TIPOS[t], a->n,
+                   p50, p99, p999, max);
+            if (tsv) {
+                fprintf(tsv, "%s\t%s\t%zu\t%.2f\t%.2f\t%.2f\t%.2f\t%ld\t%.0f\n", pr->linha, NOMES_TIPOS[t],
+                        a->n, p50, p99, p999, max, pr->rssMaxKb, rssMedio);
+            }
+        }
+        printf("%-28s RSS de pico: %ld KB (maior), %.0f KB (media); %d processo(s) com falha\n\n",
+               pr->linha, pr->rssMaxKb, rssMedio, pr->falhas);
+        falhas += pr->falhas;
+        for (int t = 0; t < NUM_TIPOS; ++t) free(pr->lat[t].v);
+        free(pr->copia);
+    }
+    if (tsv) {
+        fclose(tsv);
+        printf("(resultados em %s)\n", arquivoSaida);
+    }
+    return falhas ? EXIT_FAILURE : 0;
+}
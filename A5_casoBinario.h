@@ -0,0 +1,527 @@
+#ifndef A5_CASO_BINARIO_H
+#define A5_CASO_BINARIO_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "A5_memoria.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/* ============================================================
+   Detective Quest - Arquivo de Caso Binário (.dqc)
+   ------------------------------------------------------------
+   Formato compacto, compartilhado pelos três capítulos, para
+   carregar uma mansão sem recompilar e sem um malloc por sala.
+   O arquivo é mapeado somente-leitura (mmap) e usado no lugar:
+   vários processos abrindo o mesmo caso dividem as mesmas
+   páginas físicas. O mesmo layout, montado em memória por um
+   CasoEscritor (casoDoEscritor), é a forma compacta de qualquer
+   mansão: um vetor de salas com filhos em 32 bits e um bloco de
+   textos à parte.
+
+   Layout (inteiros na ordem de bytes da máquina que gravou):
+
+     [CasoCabecalho]             64 bytes
+     [CasoSala    x numSalas]    16 bytes cada (sala 0 = raiz)
+     [CasoPista   x numPistas]    8 bytes cada
+     [uint32_t    x numSuspeitos] deslocamento do nome
+     [textos]                    strings terminadas em '\0'
+
+   Todas as referências são índices de 32 bits ou deslocamentos
+   dentro do bloco de textos; CASO_NENHUM indica ausência.
+   A abertura valida o cabeçalho e a forma de árvore das salas
+   (casoValidarArvore, uma passada linear); os demais índices são
+   conferidos nos acessores, no momento do uso.
+   ============================================================ */
+
+#define CASO_MAGICO      "DQCASO1"
+#define CASO_VERSAO      1u
+#define CASO_MARCA_ORDEM 0x01020304u
+#define CASO_NENHUM      0xFFFFFFFFu
+
+typedef struct {
+    char     magico[8];      /* "DQCASO1\0" */
+    uint32_t versao;
+    uint32_t marcaOrdem;     /* detecta arquivo gravado em outra ordem de bytes */
+    uint32_t numSalas;
+    uint32_t numPistas;
+    uint32_t numSuspeitos;
+    uint32_t reservado;
+    uint64_t offSalas;       /* deslocamentos a partir do início do arquivo */
+    uint64_t offPistas;
+    uint64_t offSuspeitos;
+    uint64_t offTextos;
+} CasoCabecalho;
+
+typedef struct {
+    uint32_t nome;           /* deslocamento no bloco de textos */
+    uint32_t pista;          /* índice em pistas[] ou CASO_NENHUM */
+    uint32_t esq;            /* índice do filho ou CASO_NENHUM */
+    uint32_t dir;
+} CasoSala;
+
+typedef struct {
+    uint32_t texto;          /* deslocamento no bloco de textos */
+    uint32_t suspeito;       /* índice em suspeitos[] ou CASO_NENHUM */
+} CasoPista;
+
+/* Visão de um caso aberto (mapeado do disco ou montado em memória). */
+typedef struct {
+    const CasoSala  *salas;
+    const CasoPista *pistas;
+    const uint32_t  *suspeitos;
+    const char      *textos;
+    uint32_t numSalas, numPistas, numSuspeitos;
+    uint64_t tamTextos;
+    const uint32_t *ordemPistas;   /* pista -> posição alfabética (casoOrdenarPistas) */
+    uint32_t *ordemPropria;        /* ordemPistas calculada aqui (free ao fechar) */
+    void  *vetoresProprios[4];     /* salas, pistas, suspeitos e textos de casoDoEscritor() */
+    void  *base;             /* região mapeada/lida (NULL se estática) */
+    size_t tamanho;
+    int    mapeado;          /* 1 = munmap ao fechar, 0 = free */
+} CasoBinario;
+
+/* ---------------------- Acessores (leitura) ---------------------- */
+
+static inline const char *casoTexto(const CasoBinario *c, uint32_t off) {
+    return (off < c->tamTextos) ? c->textos + off : "";
+}
+
+static inline const char *casoNomeSala(const CasoBinario *c, uint32_t i) {
+    return casoTexto(c, c->salas[i].nome);
+}
+
+/* Filho validado: devolve CASO_NENHUM se o índice estiver fora do mapa. */
+static inline uint32_t casoFilho(const CasoBinario *c, uint32_t idx) {
+    return (idx < c->numSalas) ? idx : CASO_NENHUM;
+}
+
+static inline uint32_t casoEsq(const CasoBinario *c, uint32_t i) { return casoFilho(c, c->salas[i].esq); }
+static inline uint32_t casoDir(const CasoBinario *c, uint32_t i) { return casoFilho(c, c->salas[i].dir); }
+
+/* Índice da pista da sala (CASO_NENHUM se não houver). */
+static inline uint32_t casoPistaIdx(const CasoBinario *c, uint32_t sala) {
+    uint32_t p = c->salas[sala].pista;
+    return (p < c->numPistas) ? p : CASO_NENHUM;
+}
+
+/* Texto da pista da sala (NULL se não houver). */
+static inline const char *casoPistaSala(const CasoBinario *c, uint32_t sala) {
+    uint32_t p = casoPistaIdx(c, sala);
+    return (p == CASO_NENHUM) ? NULL : casoTexto(c, c->pistas[p].texto);
+}
+
+/* Índice do suspeito associado à pista (CASO_NENHUM se não houver). */
+static inline uint32_t casoSuspeitoIdx(const CasoBinario *c, uint32_t pista) {
+    uint32_t s = c->pistas[pista].suspeito;
+    return (s < c->numSuspeitos) ? s : CASO_NENHUM;
+}
+
+/* Nome do suspeito associado à pista (NULL se não houver). */
+static inline const char *casoSuspeitoPista(const CasoBinario *c, uint32_t pista) {
+    uint32_t s = c->pistas[pista].suspeito;
+    return (s < c->numSuspeitos) ? casoTexto(c, c->suspeitos[s]) : NULL;
+}
+
+/* -------------------------- Abertura -------------------------- */
+
+/* Confere cabeçalho e limites das seções; preenche a visão. */
+static inline int casoValidar(CasoBinario *c, const unsigned char *base, size_t tam, const char *caminho) {
+    const CasoCabecalho *h = (const CasoCabecalho *)base;
+    if (tam < sizeof(CasoCabecalho) || memcmp(h->magico, CASO_MAGICO, 8) != 0) {
+        fprintf(stderr, "Erro: \"%s\" nao e um arquivo de caso valido.\n", caminho);
+        return -1;
+    }
+    if (h->marcaOrdem != CASO_MARCA_ORDEM || h->versao != CASO_VERSAO) {
+        fprintf(stderr, "Erro: versao ou ordem de bytes incompativel em \"%s\".\n", caminho);
+        return -1;
+    }
+    /* deslocamento antes da contagem, e a contagem pelo espaço que sobra:
+       off + num * tamanho poderia dar a volta em 64 bits */
+    if (h->numSalas == 0 || (h->offSalas | h->offPistas | h->offSuspeitos) % 4 != 0 ||
+        h->offSalas > tam || h->offPistas > tam || h->offSuspeitos > tam ||
+        h->numSalas     > (tam - h->offSalas)     / sizeof(CasoSala) ||
+        h->numPistas    > (tam - h->offPistas)    / sizeof(CasoPista) ||
+        h->numSuspeitos > (tam - h->offSuspeitos) / sizeof(uint32_t) ||
+        h->offTextos >= tam || base[tam - 1] != '\0') {
+        fprintf(stderr, "Erro: arquivo de caso \"%s\" corrompido ou truncado.\n", caminho);
+        return -1;
+    }
+    c->salas        = (const CasoSala *)(base + h->offSalas);
+    c->pistas       = (const CasoPista *)(base + h->offPistas);
+    c->suspeitos    = (const uint32_t *)(base + h->offSuspeitos);
+    c->textos       = (const char *)(base + h->offTextos);
+    c->tamTextos    = tam - h->offTextos;
+    c->numSalas     = h->numSalas;
+    c->numPistas    = h->numPistas;
+    c->numSuspeitos = h->numSuspeitos;
+    return 0;
+}
+
+/* casoValidarArvore() – confere que as salas formam uma árvore com raiz na
+   sala 0: nenhum filho aponta para a raiz, nenhuma sala tem dois pais e a
+   descida a partir da raiz alcança todas. Com um pai por sala, a descida
+   não pode entrar em ciclo; um ciclo fora dela deixa salas sem visitar.
+   Custa O(salas) e um bit por sala; quem percorre o caso sem marcar
+   visitas (resolvedor, resumo de --dicas) depende disto, e abrirCaso()
+   o chama para todo arquivo. 0 ou -1. */
+static inline int casoValidarArvore(const CasoBinario *c, const char *caminho) {
+    uint32_t N = c->numSalas;
+    size_t cap = 64, topo = 0;
+    unsigned char *temPai = (unsigned char *)memZerada(MEM_TRABALHO, (size_t)N / 8 + 1, 1);
+    uint32_t *pilha = (uint32_t *)memAlocar(MEM_TRABALHO, cap * sizeof(uint32_t));
+    if (!temPai || !pilha) {
+        fprintf(stderr, "Erro ao alocar verificacao do caso.\n");
+        exit(EXIT_FAILURE);
+    }
+    int ok = 1;
+    for (uint32_t i = 0; i < N && ok; ++i) {
+        uint32_t filhos[2] = { casoEsq(c, i), casoDir(c, i) };
+        for (int k = 0; k < 2 && ok; ++k) {
+            uint32_t f = filhos[k];
+            if (f == CASO_NENHUM) continue;
+            ok = f != 0 && !(temPai[f / 8] & (1u << (f % 8)));
+            temPai[f / 8] |= (unsigned char)(1u << (f % 8));
+        }
+    }
+    /* descida: segue a esquerda, empilha só a direita */
+    uint64_t visitadas = 0;
+    if (ok) pilha[topo++] = 0;
+    while (topo > 0) {
+        for (uint32_t s = pilha[--topo]; s != CASO_NENHUM; s = casoEsq(c, s)) {
+            ++visitadas;
+            uint32_t dir = casoDir(c, s);
+            if (dir == CASO_NENHUM) continue;
+            if (topo == cap) {
+                cap *= 2;
+                uint32_t *nova = (uint32_t *)memRealocar(MEM_TRABALHO, pilha, cap * sizeof(uint32_t));
+                if (!nova) {
+                    fprintf(stderr, "Erro ao alocar verificacao do caso.\n");
+                    exit(EXIT_FAILURE);
+                }
+                pilha = nova;
+            }
+            pilha[topo++] = dir;
+        }
+    }
+    memLiberar(pilha);
+    memLiberar(temPai);
+    if (!ok || visitadas != N) {
+        fprintf(stderr, "Erro: arquivo de caso \"%s\" corrompido (as salas nao formam uma arvore).\n", caminho);
+        return -1;
+    }
+    return 0;
+}
+
+/* abrirCaso() – mapeia o arquivo somente-leitura e o usa no lugar.
+   Retorna 0 em caso de sucesso, -1 em erro (mensagem em stderr). */
+static inline int abrirCaso(const char *caminho, CasoBinario *c) {
+    memset(c, 0, sizeof(*c));
+#ifndef _WIN32
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Erro: nao foi possivel abrir \"%s\".\n", caminho);
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        fprintf(stderr, "Erro: arquivo de caso \"%s\" vazio.\n", caminho);
+        close(fd);
+        return -1;
+    }
+    size_t tam = (size_t)st.st_size;
+    void *base = mmap(NULL, tam, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); /* o mapeamento permanece válido */
+    if (base == MAP_FAILED) {
+        fprintf(stderr, "Erro: falha ao mapear \"%s\".\n", caminho);
+        return -1;
+    }
+    c->mapeado = 1;
+#else
+    /* Sem mmap: lê o arquivo inteiro em um único bloco. */
+    FILE *f = fopen(caminho, "rb");
+    if (!f) {
+        fprintf(stderr, "Erro: nao foi possivel abrir \"%s\".\n", caminho);
+        return -1;
+    }
+    fseek(f, 0, SEEK_END);
+    long fim = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    size_t tam = fim > 0 ? (size_t)fim : 0;
+    void *base = tam ? memAlocar(MEM_CASO, tam) : NULL;
+    if (!base || fread(base, 1, tam, f) != tam) {
+        fprintf(stderr, "Erro: falha ao ler \"%s\".\n", caminho);
+        memLiberar(base);
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+    c->mapeado = 0;
+#endif
+    c->base = base;
+    c->tamanho = tam;
+    if (casoValidar(c, (const unsigned char *)base, tam, caminho) != 0 ||
+        casoValidarArvore(c, caminho) != 0) {
+#ifndef _WIN32
+        munmap(base, tam);
+#else
+        memLiberar(base);
+#endif
+        memset(c, 0, sizeof(*c));
+        return -1;
+    }
+    return 0;
+}
+
+/* casoOrdenarPistas() – calcula a posição alfabética de cada pista, para
+   quem precisa ordenar por índice (ex.: a árvore de pistas coletadas).
+   Custa O(p log p) sobre as pistas, não sobre as salas; casos estáticos
+   já trazem a tabela pronta. */
+static const CasoBinario *casoEmOrdenacao;
+
+static inline int casoCompararPistas(const void *a, const void *b) {
+    const CasoBinario *c = casoEmOrdenacao;
+    return strcmp(casoTexto(c, c->pistas[*(const uint32_t *)a].texto),
+                  casoTexto(c, c->pistas[*(const uint32_t *)b].texto));
+}
+
+static inline void casoOrdenarPistas(CasoBinario *c) {
+    if (c->ordemPistas || c->numPistas == 0) return;
+    uint32_t *idx   = (uint32_t *)memAlocar(MEM_CASO, (size_t)c->numPistas * sizeof(uint32_t));
+    uint32_t *ordem = (uint32_t *)memAlocar(MEM_CASO, (size_t)c->numPistas * sizeof(uint32_t));
+    if (!idx || !ordem) {
+        fprintf(stderr, "Erro ao alocar ordem das pistas do caso.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t i = 0; i < c->numPistas; ++i) idx[i] = i;
+    casoEmOrdenacao = c;
+    qsort(idx, c->numPistas, sizeof(uint32_t), casoCompararPistas);
+    for (uint32_t k = 0; k < c->numPistas; ++k) ordem[idx[k]] = k;
+    memLiberar(idx);
+    c->ordemPropria = ordem;
+    c->ordemPistas = ordem;
+}
+
+static inline void fecharCaso(CasoBinario *c) {
+    if (!c) return;
+    memLiberar(c->ordemPropria);
+    c->ordemPropria = NULL;
+    for (int i = 0; i < 4; ++i) memLiberar(c->vetoresProprios[i]);
+    if (!c->base) {
+        memset(c, 0, sizeof(*c));
+        return;
+    }
+#ifndef _WIN32
+    if (c->mapeado) munmap(c->base, c->tamanho);
+    else            memLiberar(c->base);
+#else
+    memLiberar(c->base);
+#endif
+    memset(c, 0, sizeof(*c));
+}
+
+/* ------------------------- Gravação ------------------------- */
+/* CasoEscritor acumula salas, pistas, suspeitos e textos em vetores
+   crescentes e grava tudo de uma vez. Pistas e suspeitos com o mesmo
+   texto são deduplicados por uma pequena tabela de endereçamento aberto. */
+
+typedef struct {
+    CasoSala  *salas;     uint32_t numSalas,     capSalas;
+    CasoPista *pistas;    uint32_t numPistas,    capPistas;
+    uint32_t  *suspeitos; uint32_t numSuspeitos, capSuspeitos;
+    char      *textos;    uint64_t tamTextos,    capTextos;
+    uint32_t  *dedup;     uint32_t capDedup;     /* 0 = vazio; senão (1 + id), bit 31 = suspeito */
+} CasoEscritor;
+
+static inline void *casoCrescer(void *v, uint64_t *cap, uint64_t necessario, size_t elem) {
+    if (necessario <= *cap) return v;
+    uint64_t nova = *cap ? *cap : 16;
+    while (nova < necessario) nova *= 2;
+    void *p = memRealocar(MEM_CASO, v, (size_t)(nova * elem));
+    if (!p) {
+        fprintf(stderr, "Erro ao alocar memoria para o caso.\n");
+        exit(EXIT_FAILURE);
+    }
+    *cap = nova;
+    return p;
+}
+
+static inline uint32_t escritorTexto(CasoEscritor *e, const char *s) {
+    size_t n = strlen(s) + 1;
+    if (e->tamTextos + n > 0xFFFFFFFFull) {
+        fprintf(stderr, "Erro: bloco de textos do caso excede 4 GiB.\n");
+        exit(EXIT_FAILURE);
+    }
+    e->textos = (char *)casoCrescer(e->textos, &e->capTextos, e->tamTextos + n, 1);
+    uint32_t off = (uint32_t)e->tamTextos;
+    memcpy(e->textos + off, s, n);
+    e->tamTextos += n;
+    return off;
+}
+
+static inline uint32_t casoHashTexto(const char *s) {
+    uint32_t h = 2166136261u; /* FNV-1a */
+    while (*s) { h ^= (unsigned char)*s++; h *= 16777619u; }
+    return h;
+}
+
+/* Procura (ou reserva) a posição de um texto na tabela de deduplicação. */
+static inline uint32_t *escritorDedup(CasoEscritor *e, const char *s, uint32_t marca);
+
+static inline void escritorRehash(CasoEscritor *e) {
+    uint32_t *velha = e->dedup, capVelha = e->capDedup;
+    e->capDedup = capVelha ? capVelha * 2 : 64;
+    e->dedup = (uint32_t *)memZerada(MEM_CASO, e->capDedup, sizeof(uint32_t));
+    if (!e->dedup) {
+        fprintf(stderr, "Erro ao alocar memoria para o caso.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t i = 0; i < capVelha; ++i) {
+        uint32_t v = velha[i];
+        if (!v) continue;
+        uint32_t marca = v & 0x80000000u, id = (v & 0x7FFFFFFFu) - 1;
+        const char *s = e->textos + (marca ? e->suspeitos[id] : e->pistas[id].texto);
+        *escritorDedup(e, s, marca) = v;
+    }
+    memLiberar(velha);
+}
+
+static inline uint32_t *escritorDedup(CasoEscritor *e, const char *s, uint32_t marca) {
+    uint32_t mask = e->capDedup - 1;
+    for (uint32_t i = (casoHashTexto(s) ^ marca) & mask;; i = (i + 1) & mask) {
+        uint32_t v = e->dedup[i];
+        if (!v) return &e->dedup[i];
+        if ((v & 0x80000000u) != marca) continue;
+        uint32_t id = (v & 0x7FFFFFFFu) - 1;
+        const char *t = e->textos + (marca ? e->suspeitos[id] : e->pistas[id].texto);
+        if (strcmp(s, t) == 0) return &e->dedup[i];
+    }
+}
+
+static inline uint32_t escritorBusca(CasoEscritor *e, const char *s, uint32_t marca, int *novo) {
+    if ((uint64_t)(e->numPistas + e->numSuspeitos + 1) * 2 > e->capDedup) escritorRehash(e);
+    uint32_t *pos = escritorDedup(e, s, marca);
+    *novo = (*pos == 0);
+    return *pos ? (*pos & 0x7FFFFFFFu) - 1 : 0;
+}
+
+/* Registra um suspeito (ou devolve o índice já existente). */
+static inline uint32_t escritorSuspeito(CasoEscritor *e, const char *nome) {
+    int novo;
+    uint32_t id = escritorBusca(e, nome, 0x80000000u, &novo);
+    if (!novo) return id;
+    uint64_t cap = e->capSuspeitos;
+    e->suspeitos = (uint32_t *)casoCrescer(e->suspeitos, &cap, (uint64_t)e->numSuspeitos + 1, sizeof(uint32_t));
+    e->capSuspeitos = (uint32_t)cap;
+    id = e->numSuspeitos++;
+    e->suspeitos[id] = escritorTexto(e, nome);
+    *escritorDedup(e, nome, 0x80000000u) = 0x80000000u | (id + 1);
+    return id;
+}
+
+/* Registra uma pista (deduplicada pelo texto); suspeito pode ser NULL. */
+static inline uint32_t escritorPista(CasoEscritor *e, const char *texto, const char *suspeito) {
+    int novo;
+    uint32_t id = escritorBusca(e, texto, 0, &novo);
+    if (!novo) return id;
+    uint32_t sus = suspeito ? escritorSuspeito(e, suspeito) : CASO_NENHUM;
+    uint64_t cap = e->capPistas;
+    e->pistas = (CasoPista *)casoCrescer(e->pistas, &cap, (uint64_t)e->numPistas + 1, sizeof(CasoPista));
+    e->capPistas = (uint32_t)cap;
+    id = e->numPistas++;
+    e->pistas[id].texto = escritorTexto(e, texto);
+    e->pistas[id].suspeito = sus;
+    *escritorDedup(e, texto, 0) = id + 1;
+    return id;
+}
+
+/* Acrescenta uma sala; filhos são ligados depois via escritorLigar(). */
+static inline uint32_t escritorSala(CasoEscritor *e, const char *nome, uint32_t pista) {
+    uint64_t cap = e->capSalas;
+    e->salas = (CasoSala *)casoCrescer(e->salas, &cap, (uint64_t)e->numSalas + 1, sizeof(CasoSala));
+    e->capSalas = (uint32_t)cap;
+    uint32_t id = e->numSalas++;
+    e->salas[id].nome  = escritorTexto(e, nome);
+    e->salas[id].pista = pista;
+    e->salas[id].esq   = CASO_NENHUM;
+    e->salas[id].dir   = CASO_NENHUM;
+    return id;
+}
+
+static inline void escritorLigar(CasoEscritor *e, uint32_t sala, uint32_t esq, uint32_t dir) {
+    e->salas[sala].esq = esq;
+    e->salas[sala].dir = dir;
+}
+
+/* gravarCaso() – grava o caso acumulado. Retorna 0 ou -1 (erro em stderr). */
+static inline int gravarCaso(const CasoEscritor *e, const char *caminho) {
+    CasoCabecalho h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magico, CASO_MAGICO, 8);
+    h.versao       = CASO_VERSAO;
+    h.marcaOrdem   = CASO_MARCA_ORDEM;
+    h.numSalas     = e->numSalas;
+    h.numPistas    = e->numPistas;
+    h.numSuspeitos = e->numSuspeitos;
+    h.offSalas     = sizeof(CasoCabecalho);
+    h.offPistas    = h.offSalas     + (uint64_t)e->numSalas     * sizeof(CasoSala);
+    h.offSuspeitos = h.offPistas    + (uint64_t)e->numPistas    * sizeof(CasoPista);
+    h.offTextos    = h.offSuspeitos + (uint64_t)e->numSuspeitos * sizeof(uint32_t);
+
+    FILE *f = fopen(caminho, "wb");
+    if (!f) {
+        fprintf(stderr, "Erro: nao foi possivel criar \"%s\".\n", caminho);
+        return -1;
+    }
+    int ok = fwrite(&h, sizeof(h), 1, f) == 1
+          && fwrite(e->salas,     sizeof(CasoSala),  e->numSalas,     f) == e->numSalas
+          && fwrite(e->pistas,    sizeof(CasoPista), e->numPistas,    f) == e->numPistas
+          && fwrite(e->suspeitos, sizeof(uint32_t),  e->numSuspeitos, f) == e->numSuspeitos
+          && fwrite(e->textos, 1, (size_t)e->tamTextos, f) == e->tamTextos;
+    if (fclose(f) != 0) ok = 0;
+    if (!ok) {
+        fprintf(stderr, "Erro ao gravar \"%s\".\n", caminho);
+        return -1;
+    }
+    return 0;
+}
+
+/* casoDoEscritor() – entrega os vetores acumulados a uma visão em memória,
+   sem copiar nem gravar: o caso passa a ser dono deles (fecharCaso libera)
+   e o escritor volta vazio. */
+static inline void casoDoEscritor(CasoEscritor *e, CasoBinario *c) {
+    memset(c, 0, sizeof(*c));
+    c->salas        = e->salas;
+    c->pistas       = e->pistas;
+    c->suspeitos    = e->suspeitos;
+    c->textos       = e->textos;
+    c->tamTextos    = e->tamTextos;
+    c->numSalas     = e->numSalas;
+    c->numPistas    = e->numPistas;
+    c->numSuspeitos = e->numSuspeitos;
+    c->vetoresProprios[0] = e->salas;
+    c->vetoresProprios[1] = e->pistas;
+    c->vetoresProprios[2] = e->suspeitos;
+    c->vetoresProprios[3] = e->textos;
+    memLiberar(e->dedup);
+    memset(e, 0, sizeof(*e));
+}
+
+static inline void liberarEscritor(CasoEscritor *e) {
+    memLiberar(e->salas);
+    memLiberar(e->pistas);
+    memLiberar(e->suspeitos);
+    memLiberar(e->textos);
+    memLiberar(e->dedup);
+    memset(e, 0, sizeof(*e));
+}
+
+#endif /* A5_CASO_BINARIO_H */
@@ -0,0 +1,79 @@
+/* Gerado por A5_gerarTabelasCaso.c a partir de "mansao.dqc" - nao editar. */
+#ifndef A5_CASO_MANSAO_H
+#define A5_CASO_MANSAO_H
+
+#include "A5_casoBinario.h"
+
+#define CASO_ESTATICO_NUM_SALAS     11u
+#define CASO_ESTATICO_NUM_PISTAS    9u
+#define CASO_ESTATICO_NUM_SUSPEITOS 6u
+
+static const CasoSala casoEstaticoSalas[11] = {
+    { 27u, 0x0u, 0x1u, 0x2u }, /* 0: Hall de Entrada */
+    { 78u, 0x1u, 0x3u, 0x4u }, /* 1: Sala de Estar */
+    { 120u, 0x2u, 0x5u, 0x6u }, /* 2: Corredor */
+    { 169u, 0x3u, 0x7u, 0x8u }, /* 3: Biblioteca */
+    { 180u, 0xFFFFFFFFu, 0xFFFFFFFFu, 0x9u }, /* 4: Cozinha */
+    { 220u, 0x4u, 0xFFFFFFFFu, 0xFFFFFFFFu }, /* 5: Escritorio */
+    { 245u, 0x5u, 0xFFFFFFFFu, 0xAu }, /* 6: Jardim */
+    { 268u, 0x6u, 0xFFFFFFFFu, 0xFFFFFFFFu }, /* 7: Adega */
+    { 274u, 0xFFFFFFFFu, 0xFFFFFFFFu, 0xFFFFFFFFu }, /* 8: Deposito */
+    { 314u, 0x7u, 0xFFFFFFFFu, 0xFFFFFFFFu }, /* 9: Despensa */
+    { 339u, 0x8u, 0xFFFFFFFFu, 0xFFFFFFFFu }, /* 10: Estufa */
+};
+
+static const CasoPista casoEstaticoPistas[9] = {
+    { 11u, 0x0u }, /* 0: Pegadas de lama */
+    { 55u, 0x1u }, /* 1: Almofada fora do lugar */
+    { 106u, 0x2u }, /* 2: Perfume forte */
+    { 148u, 0x3u }, /* 3: Livro raro deslocado */
+    { 201u, 0x4u }, /* 4: Janela entreaberta */
+    { 231u, 0x4u }, /* 5: Luva de couro */
+    { 252u, 0xFFFFFFFFu }, /* 6: Taça com batom */
+    { 297u, 0x5u }, /* 7: Rastro de acucar */
+    { 323u, 0x0u }, /* 8: Terra revolvida */
+};
+
+static const uint32_t casoEstaticoOrdemPistas[9] = {
+    4u, 0u, 5u, 2u, 1u, 3u, 7u, 6u, 8u,
+};
+
+static const uint32_t casoEstaticoSuspeitos[6] = {
+    0u, /* 0: Jardineiro */
+    43u, /* 1: Sra. Branca */
+    92u, /* 2: Srta. Violeta */
+    129u, /* 3: Professor Carvalho */
+    188u, /* 4: Sr. Mostarda */
+    283u, /* 5: Dra. Orquidea */
+};
+
+static const char casoEstaticoTextos[] =
+    "Jardineiro\0"
+    "Pegadas de lama\0"
+    "Hall de Entrada\0"
+    "Sra. Branca\0"
+    "Almofada fora do lugar\0"
+    "Sala de Estar\0"
+    "Srta. Violeta\0"
+    "Perfume forte\0"
+    "Corredor\0"
+    "Professor Carvalho\0"
+    "Livro raro deslocado\0"
+    "Biblioteca\0"
+    "Cozinha\0"
+    "Sr. Mostarda\0"
+    "Janela entreaberta\0"
+    "Escritorio\0"
+    "Luva de couro\0"
+    "Jardim\0"
+    "Ta\303\247a com batom\0"
+    "Adega\0"
+    "Deposito\0"
+    "Dra. Orquidea\0"
+    "Rastro de acucar\0"
+    "Despensa\0"
+    "Terra revolvida\0"
+    "Estufa\0"
+    ;
+
+#endif /* A5_CASO_MANSAO_H */
@@ -1,158 +1,51 @@
+#define _POSIX_C_SOURCE 200809L  /* sigaction (A5_estatisticas.h) */
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+
+#define DQ_PISTAS_NA_SALA      /* a sala guarda o texto da pista */
+#include "A5_detetiveCore.h"
 
 /* ============================================================
    Detective Quest - Coleta de Pistas
    ------------------------------------------------------------
    Requisitos atendidos:
    - Árvore binária para o mapa (Salas com nome e pista).
-   - Árvore BST para armazenar pistas coletadas.
+   - Árvore BST (balanceada, AVL) para armazenar pistas coletadas.
+   - Mapa e pistas em arenas: liberação de uma vez, sem percorrer nós.
    - Exploração a partir do Hall (e/d/s), coleta automática.
    - Exibição das pistas em ordem alfabética ao final.
+   - Roteiros sem terminal: --replay arquivo (uma sessão por linha).
    - Código organizado, nomes claros e comentários.
+   - Núcleo comum (A5_detetiveCore.h) com DQ_PISTAS_NA_SALA: arena,
+     salas, AVL de pistas por texto, entrada, saída e exportação.
+   - Caso externo em formato binário (A5_casoBinario.h):
+       --caso arquivo.dqc           joga o caso mapeado do disco
+       --exportar-caso arquivo.dqc  grava a mansão embutida e sai
+   - Saída num buffer único, descarregado antes de ler o jogador;
+     --silencioso tira menus, caminhos e prompts da tela.
+   - --stats (com -DDQ_ESTATISTICAS, A5_estatisticas.h): profundidade
+     e comparações da BST de pistas, bytes alocados e tempo por
+     jogada, em JSON no stderr ao sair.
+   - --memoria (com -DDQ_MEMORIA, A5_memoria.h): bytes vivos e pico
+     de salas, nomes, pistas e textos, folga das arenas; vazamentos
+     sempre acusados ao sair.
    ============================================================ */
 
-/* ---------------------------- Estruturas ---------------------------- */
-typedef struct Sala {
-    char *nome;             /* nome do cômodo */
-    char *pista;            /* pista opcional (pode ser NULL) */
-    struct Sala *esq;       /* caminho esquerda */
-    struct Sala *dir;       /* caminho direita */
-} Sala;
-
-/* Nó da BST de pistas (armazenadas ordenadas por texto) */
-typedef struct PistaNode {
-    char *texto;                /* conteúdo da pista */
-    int count;                  /* qtd de vezes coletada (caso repetida) */
-    struct PistaNode *esq, *dir;
-} PistaNode;
-
-/* ----------------------- Utilidades de string ----------------------- */
-/* Implementação própria do strdup para portabilidade. */
-static char *duplicaString(const char *s) {
-    if (!s) return NULL;
-    size_t n = strlen(s) + 1;
-    char *p = (char *)malloc(n);
-    if (!p) return NULL;
-    memcpy(p, s, n);
-    return p;
-}
-
-/* ------------------ Criação e destruição (Salas) ------------------- */
-/* criarSala() – cria dinamicamente um cômodo com ou sem pista. */
-Sala *criarSala(const char *nome, const char *pista) {
-    Sala *nova = (Sala *)malloc(sizeof(Sala));
-    if (!nova) {
-        fprintf(stderr, "Erro ao alocar sala \"%s\".\n", nome);
-        exit(EXIT_FAILURE);
-    }
-    nova->nome = duplicaString(nome);
-    if (!nova->nome) {
-        fprintf(stderr, "Erro ao alocar nome da sala.\n");
-        free(nova);
-        exit(EXIT_FAILURE);
-    }
-    /* pista é opcional; se string vazia, trate como NULL */
-    if (pista && pista[0] != '\0') {
-        nova->pista = duplicaString(pista);
-        if (!nova->pista) {
-            fprintf(stderr, "Erro ao alocar pista da sala.\n");
-            free(nova->nome);
-            free(nova);
-            exit(EXIT_FAILURE);
-        }
-    } else {
-        nova->pista = NULL;
-    }
-    nova->esq = nova->dir = NULL;
-    return nova;
-}
-
-void liberarArvoreSalas(Sala *r) {
-    if (!r) return;
-    liberarArvoreSalas(r->esq);
-    liberarArvoreSalas(r->dir);
-    free(r->nome);
-    free(r->pista);
-    free(r);
-}
-
-/* -------------------- Criação e destruição (BST) -------------------- */
-/* inserirPista() – insere nova pista na BST (ordem alfabética).
-   Se a pista já existir, apenas incrementa o contador. */
-void inserirPista(PistaNode **raiz, const char *texto) {
-    if (!texto || texto[0] == '\0') return; /* ignora pistas vazias */
-
-    if (*raiz == NULL) {
-        PistaNode *novo = (PistaNode *)malloc(sizeof(PistaNode));
-        if (!novo) {
-            fprintf(stderr, "Erro ao alocar nó de pista.\n");
-            exit(EXIT_FAILURE);
-        }
-        novo->texto = duplicaString(texto);
-        if (!novo->texto) {
-            fprintf(stderr, "Erro ao alocar texto da pista.\n");
-            free(novo);
-            exit(EXIT_FAILURE);
-        }
-        novo->count = 1;
-        novo->esq = novo->dir = NULL;
-        *raiz = novo;
-        return;
-    }
-
-    int cmp = strcmp(texto, (*raiz)->texto);
-    if (cmp == 0) {
-        (*raiz)->count++;
-    } else if (cmp < 0) {
-        inserirPista(&((*raiz)->esq), texto);
-    } else {
-        inserirPista(&((*raiz)->dir), texto);
-    }
-}
-
-/* exibirPistas() – imprime a BST in-order (ordem alfabética). */
-void exibirPistas(PistaNode *r) {
-    if (!r) return;
-    exibirPistas(r->esq);
-    if (r->count > 1)
-        printf("- %s (x%d)\n", r->texto, r->count);
-    else
-        printf("- %s\n", r->texto);
-    exibirPistas(r->dir);
-}
-
-void liberarArvorePistas(PistaNode *r) {
-    if (!r) return;
-    liberarArvorePistas(r->esq);
-    liberarArvorePistas(r->dir);
-    free(r->texto);
-    free(r);
-}
-
 /* ------------------------- UI e interação -------------------------- */
 static void cabecalho() {
-    printf("\n==============================================\n");
-    printf("   Detective Quest - Coleta de Pistas (BST)   \n");
-    printf("==============================================\n");
-}
-
-/* Lê primeira letra não-espaço e normaliza minúscula */
-static char lerOpcao() {
-    char linha[64];
-    if (!fgets(linha, sizeof(linha), stdin)) return 's';
-    for (size_t i = 0; linha[i]; ++i) {
-        if (!isspace((unsigned char)linha[i]))
-            return (char)tolower((unsigned char)linha[i]);
-    }
-    return 's';
+    textoMenu("\n==============================================\n");
+    textoMenu("   Detective Quest - Coleta de Pistas (BST)   \n");
+    textoMenu("==============================================\n");
 }
 
 /* explorarSalasComPistas() – controla a navegação e coleta de pistas.
    A cada sala visitada, se houver pista, ela é inserida na BST. */
-void explorarSalasComPistas(Sala *hall, PistaNode **pistas) {
+void explorarSalasComPistas(Arena *sessao, Sala *hall, PistaNode **pistas) {
     if (!hall) {
         printf("Mapa inexistente.\n");
         return;
@@ -163,7 +56,7 @@ void explorarSalasComPistas(Sala *hall, PistaNode **pistas) {
 
     /* coleta pista do Hall imediatamente */
     if (atual->pista) {
-        inserirPista(pistas, atual->pista);
+        inserirPista(sessao, pistas, atual->pista);
         printf("Voce esta no %s.\n", atual->nome);
         printf("Pista encontrada aqui: \"%s\"\n", atual->pista);
     } else {
@@ -171,11 +64,11 @@ void explorarSalasComPistas(Sala *hall, PistaNode **pistas) {
     }
 
     while (1) {
-        printf("\nCaminhos disponiveis a partir de \"%s\":\n", atual->nome);
-        if (atual->esq) printf("  (e) Esquerda: %s\n", atual->esq->nome);
-        if (atual->dir) printf("  (d) Direita : %s\n", atual->dir->nome);
-        printf("  (s) Sair da exploracao\n");
-        printf("Escolha [e/d/s]: ");
+        textoMenu("\nCaminhos disponiveis a partir de \"%s\":\n", atual->nome);
+        if (atual->esq) textoMenu("  (e) Esquerda: %s\n", atual->esq->nome);
+        if (atual->dir) textoMenu("  (d) Direita : %s\n", atual->dir->nome);
+        textoMenu("  (s) Sair da exploracao\n");
+        textoMenu("Escolha [e/d/s]: ");
 
         char op = lerOpcao();
         if (op == 's') {
@@ -200,13 +93,126 @@ void explorarSalasComPistas(Sala *hall, PistaNode **pistas) {
 
         /* Ao entrar na nova sala, coletar pista (se houver) */
         if (atual->pista) {
-            inserirPista(pistas, atual->pista);
+            inserirPista(sessao, pistas, atual->pista);
             printf("\nVoce entrou em: %s\n", atual->nome);
             printf("Pista encontrada: \"%s\"\n", atual->pista);
         } else {
             printf("\nVoce entrou em: %s (Sem pista aqui)\n", atual->nome);
         }
     }
+    descartarComandos();
+}
+
+/* explorarCasoComPistas() – mesma navegação, direto sobre o caso binário
+   mapeado. As pistas são lidas do arquivo no lugar e copiadas só na BST. */
+void explorarCasoComPistas(Arena *sessao, const CasoBinario *c, PistaNode **pistas) {
+    cabecalho();
+    uint32_t atual = 0; /* sala 0 = Hall */
+
+    const char *pista = casoPistaSala(c, atual);
+    if (pista) {
+        inserirPista(sessao, pistas, pista);
+        printf("Voce esta no %s.\n", casoNomeSala(c, atual));
+        printf("Pista encontrada aqui: \"%s\"\n", pista);
+    } else {
+        printf("Voce esta no %s. (Sem pista aqui)\n", casoNomeSala(c, atual));
+    }
+
+    while (1) {
+        uint32_t esq = casoEsq(c, atual), dir = casoDir(c, atual);
+        textoMenu("\nCaminhos disponiveis a partir de \"%s\":\n", casoNomeSala(c, atual));
+        if (esq != CASO_NENHUM) textoMenu("  (e) Esquerda: %s\n", casoNomeSala(c, esq));
+        if (dir != CASO_NENHUM) textoMenu("  (d) Direita : %s\n", casoNomeSala(c, dir));
+        textoMenu("  (s) Sair da exploracao\n");
+        textoMenu("Escolha [e/d/s]: ");
+
+        char op = lerOpcao();
+        if (op == 's') {
+            printf("\nExploracao encerrada pelo jogador.\n");
+            break;
+        } else if (op == 'e') {
+            if (esq == CASO_NENHUM) {
+                printf("Nao ha caminho a esquerda.\n");
+                continue;
+            }
+            atual = esq;
+        } else if (op == 'd') {
+            if (dir == CASO_NENHUM) {
+                printf("Nao ha caminho a direita.\n");
+                continue;
+            }
+            atual = dir;
+        } else {
+            printf("Opcao invalida. Use 'e', 'd' ou 's'.\n");
+            continue;
+        }
+
+        pista = casoPistaSala(c, atual);
+        if (pista) {
+            inserirPista(sessao, pistas, pista);
+            printf("\nVoce entrou em: %s\n", casoNomeSala(c, atual));
+            printf("Pista encontrada: \"%s\"\n", pista);
+        } else {
+            printf("\nVoce entrou em: %s (Sem pista aqui)\n", casoNomeSala(c, atual));
+        }
+    }
+    descartarComandos();
+}
+
+/* ------------------- Roteiros (modo não interativo) ------------------- */
+/* --replay arquivo ("-" = entrada padrão): uma sessão por linha, com os
+   movimentos e/d/s do menu (ex.: "dds"); o que vier depois do primeiro
+   espaço é ignorado, para aceitar os mesmos roteiros do capítulo final.
+   Linhas vazias ou iniciadas por '#' são ignoradas. Sem menus: cada
+   sessão gera um registro "numero;pistas coletadas;sala final". */
+
+/* Anda pelo mapa embutido; devolve a sala final. */
+static const Sala *roteiroSalas(const Sala *atual, const char *mov, int *coletas) {
+    if (atual->pista) ++*coletas;
+    for (; *mov && *mov != ' '; ++mov) {
+        char op = (char)tolower((unsigned char)*mov);
+        const Sala *prox = (op == 'e') ? atual->esq : (op == 'd') ? atual->dir : NULL;
+        if (op == 's') break;
+        if (!prox) continue;
+        atual = prox;
+        if (atual->pista) ++*coletas;
+    }
+    return atual;
+}
+
+/* Mesmo roteiro sobre o caso carregado; devolve o índice da sala final. */
+static uint32_t roteiroCaso(const CasoBinario *c, const char *mov, int *coletas) {
+    uint32_t atual = 0; /* sala 0 = Hall */
+    if (casoPistaIdx(c, atual) != CASO_NENHUM) ++*coletas;
+    for (; *mov && *mov != ' '; ++mov) {
+        char op = (char)tolower((unsigned char)*mov);
+        uint32_t prox = (op == 'e') ? casoEsq(c, atual) : (op == 'd') ? casoDir(c, atual) : CASO_NENHUM;
+        if (op == 's') break;
+        if (prox == CASO_NENHUM) continue;
+        atual = prox;
+        if (casoPistaIdx(c, atual) != CASO_NENHUM) ++*coletas;
+    }
+    return atual;
+}
+
+/* executarRoteiros() – roda as sessões de 'in' e escreve os registros em 'out'. */
+unsigned long executarRoteiros(FILE *in, FILE *out, const CasoBinario *caso, const Sala *mapa) {
+    char *linha = NULL;
+    size_t cap = 0;
+    unsigned long numero = 0;
+    while (lerLinhaLonga(in, &linha, &cap)) {
+        char *mov = linha;
+        while (*mov == ' ' || *mov == '\t') ++mov;
+        if (*mov == '\n' || *mov == '\r' || *mov == '\0' || *mov == '#') continue;
+
+        int coletas = 0;
+        const char *salaFinal = (caso && caso->salas)
+            ? casoNomeSala(caso, roteiroCaso(caso, mov, &coletas))
+            : roteiroSalas(mapa, mov, &coletas)->nome;
+        fprintf(out, "%lu;%d;%s\n", ++numero, coletas, salaFinal);
+    }
+    memLiberar(linha);
+    return numero;
 }
 
 /* ---------------------- Montagem do mapa fixo ---------------------- */
@@ -223,18 +229,18 @@ void explorarSalasComPistas(Sala *hall, PistaNode **pistas) {
 
    Alguns cômodos têm pistas, outros não.
 */
-Sala *montarMapa() {
-    Sala *hall        = criarSala("Hall de Entrada",     "Pegadas de lama");
-    Sala *estar       = criarSala("Sala de Estar",       NULL);
-    Sala *corredor    = criarSala("Corredor",            "Perfume forte");
-    Sala *biblio      = criarSala("Biblioteca",          "Livro fora do lugar");
-    Sala *cozinha     = criarSala("Cozinha",             NULL);
-    Sala *escritorio  = criarSala("Escritorio",          "Janela entreaberta");
-    Sala *jardim      = criarSala("Jardim",              "Luva perdida");
-    Sala *adega       = criarSala("Adega",               "Taça quebrada");
-    Sala *deposito    = criarSala("Deposito",            NULL);
-    Sala *despensa    = criarSala("Despensa",            "Rastro de açúcar");
-    Sala *estufa      = criarSala("Estufa",              "Terra revolvida");
+Sala *montarMapa(Arena *a) {
+    Sala *hall        = criarSala(a, "Hall de Entrada",     "Pegadas de lama");
+    Sala *estar       = criarSala(a, "Sala de Estar",       NULL);
+    Sala *corredor    = criarSala(a, "Corredor",            "Perfume forte");
+    Sala *biblio      = criarSala(a, "Biblioteca",          "Livro fora do lugar");
+    Sala *cozinha     = criarSala(a, "Cozinha",             NULL);
+    Sala *escritorio  = criarSala(a, "Escritorio",          "Janela entreaberta");
+    Sala *jardim      = criarSala(a, "Jardim",              "Luva perdida");
+    Sala *adega       = criarSala(a, "Adega",               "Taça quebrada");
+    Sala *deposito    = criarSala(a, "Deposito",            NULL);
+    Sala *despensa    = criarSala(a, "Despensa",            "Rastro de açúcar");
+    Sala *estufa      = criarSala(a, "Estufa",              "Terra revolvida");
 
     /* ligações */
     hall->esq = estar;
@@ -256,24 +262,84 @@ Sala *montarMapa() {
 }
 
 /* ------------------------------- main ------------------------------ */
-int main(void) {
-    Sala *mapa = montarMapa();
+int main(int argc, char **argv) {
+    const char *arquivoCaso = NULL, *arquivoExportar = NULL, *arquivoRoteiros = NULL;
+    iniciarSaida();
+    iniciarEntrada();
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--caso") == 0 && i + 1 < argc) {
+            arquivoCaso = argv[++i];
+        } else if (strcmp(argv[i], "--exportar-caso") == 0 && i + 1 < argc) {
+            arquivoExportar = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            arquivoRoteiros = argv[++i];
+        } else if (strcmp(argv[i], "--silencioso") == 0) {
+            silencioso = 1;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            estAtivar("detetiveAventureiro");
+        } else if (strcmp(argv[i], "--memoria") == 0) {
+            memAtivar("detetiveAventureiro");
+        } else {
+            fprintf(stderr, "Uso: %s [--caso arquivo.dqc] [--exportar-caso arquivo.dqc]"
+                            " [--replay roteiros.txt|-] [--silencioso] [--stats] [--memoria]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* arena do caso (mapa) e arena da sessão (pistas coletadas) */
+    CasoBinario caso;
+    memset(&caso, 0, sizeof(caso));
+    Arena arenaMapa = { NULL, NULL }, arenaSessao = { NULL, NULL };
+    Sala *mapa = NULL;
+    if (arquivoCaso) {
+        if (abrirCaso(arquivoCaso, &caso) != 0) return EXIT_FAILURE;
+    } else {
+        mapa = montarMapa(&arenaMapa);
+    }
+
+    if (arquivoExportar) {
+        int r = mapa ? exportarCaso(mapa, arquivoExportar) : -1;
+        if (!mapa) fprintf(stderr, "Erro: --exportar-caso usa a mansao embutida.\n");
+        arenaLiberar(&arenaMapa);
+        fecharCaso(&caso);
+        estEncerrar();
+        memEncerrar();
+        return r == 0 ? 0 : EXIT_FAILURE;
+    }
+
+    if (arquivoRoteiros) {
+        FILE *in = strcmp(arquivoRoteiros, "-") == 0 ? stdin : fopen(arquivoRoteiros, "r");
+        if (!in) {
+            perror(arquivoRoteiros);
+        } else {
+            executarRoteiros(in, stdout, &caso, mapa);
+            fflush(stdout);
+            if (in != stdin) fclose(in);
+        }
+        arenaLiberar(&arenaMapa);
+        fecharCaso(&caso);
+        estEncerrar();
+        memEncerrar();
+        return in ? 0 : EXIT_FAILURE;
+    }
 
     while (1) {
-        printf("\n===== Menu =====\n");
-        printf("1 - Explorar mansao e coletar pistas\n");
-        printf("0 - Sair\n");
-        printf("Opcao: ");
+        textoMenu("\n===== Menu =====\n");
+        textoMenu("1 - Explorar mansao e coletar pistas\n");
+        textoMenu("0 - Sair\n");
+        textoMenu("Opcao: ");
 
         char linha[32];
-        if (!fgets(linha, sizeof(linha), stdin)) break;
+        fflush(stdout);
+        if (!estLerLinha(linha, sizeof(linha), stdin)) break;
         int opcao = atoi(linha);
 
         if (opcao == 1) {
             /* BST de pistas inicia vazia para cada exploração */
             PistaNode *pistas = NULL;
 
-            explorarSalasComPistas(mapa, &pistas);
+            if (caso.salas) explorarCasoComPistas(&arenaSessao, &caso, &pistas);
+            else            explorarSalasComPistas(&arenaSessao, mapa, &pistas);
 
             printf("\n=========== Pistas coletadas (ordem alfabetica) ===========\n");
             if (pistas) {
@@ -283,7 +349,7 @@ int main(void) {
             }
             printf("===========================================================\n");
 
-            liberarArvorePistas(pistas);
+            arenaReiniciar(&arenaSessao); /* descarta a BST inteira em O(1) */
         } else if (opcao == 0) {
             break;
         } else {
@@ -291,7 +357,12 @@ int main(void) {
         }
     }
 
-    liberarArvoreSalas(mapa);
+    arenaLiberar(&arenaSessao);
+    arenaLiberar(&arenaMapa);
+    fecharCaso(&caso);
     printf("Programa encerrado. Ate a proxima!\n");
+    fflush(stdout);
+    estEncerrar();
+    memEncerrar();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,586 @@
+#ifndef A5_DETETIVE_CORE_H
+#define A5_DETETIVE_CORE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include <stdarg.h>
+
+#include "A5_casoBinario.h"
+#include "A5_estatisticas.h"
+#include "A5_memoria.h"
+
+/* ============================================================
+   Detective Quest - Núcleo comum dos capítulos
+   ------------------------------------------------------------
+   Arena, salas, árvore de pistas, saída, entrada e exportação,
+   escritos uma vez para os três programas. Cada capítulo liga,
+   antes do #include, só o que usa; o resto nem é compilado:
+
+     (nenhuma)           salas só com nome (Novato)
+     DQ_PISTAS_NA_SALA   a sala guarda o texto da sua pista; a
+                         árvore de pistas compara e copia textos
+                         (Aventureiro)
+     DQ_PISTAS_POR_NOME  a pista vem da tabela sala -> pista,
+                         consultada pelo nome em criarSala(); a
+                         sala guarda o id internado e a árvore
+                         compara a posição alfabética (Mestre,
+                         que fornece internar(), textoInterno()
+                         e pistaDaSala())
+     DQ_SUSPEITOS        cada pista coletada leva o id do seu
+                         suspeito (exige DQ_PISTAS_POR_NOME)
+
+   Tudo aqui é static inline: o que um capítulo não chama não
+   entra no binário nem gera aviso.
+   ============================================================ */
+
+#if defined(DQ_PISTAS_NA_SALA) && defined(DQ_PISTAS_POR_NOME)
+#error "DQ_PISTAS_NA_SALA e DQ_PISTAS_POR_NOME se excluem"
+#endif
+#if defined(DQ_SUSPEITOS) && !defined(DQ_PISTAS_POR_NOME)
+#error "DQ_SUSPEITOS exige DQ_PISTAS_POR_NOME (pistas com id)"
+#endif
+#if defined(DQ_PISTAS_NA_SALA) || defined(DQ_PISTAS_POR_NOME)
+#define DQ_COM_PISTAS
+#endif
+
+/* Id de texto internado ausente (mesmo valor de CASO_NENHUM). */
+#define ID_NENHUM 0xFFFFFFFFu
+
+/* ------------------ Arena (alocação em bloco) ------------------ */
+/* Salas, nós e textos vêm de blocos grandes, por incremento de ponteiro.
+   Nada é liberado individualmente: a arena inteira é reiniciada ou
+   liberada de uma vez, sem percorrer as estruturas que moram nela. */
+typedef struct BlocoArena {
+    struct BlocoArena *prox;
+    size_t capacidade;          /* bytes disponíveis em dados[] */
+    size_t usado;
+    MEM_ARENA_CAMPO             /* -DDQ_MEMORIA: pedidos por etiqueta (no 1º bloco) */
+    unsigned char dados[];
+} BlocoArena;
+
+typedef struct Arena {
+    BlocoArena *primeiro;
+    BlocoArena *atual;          /* bloco de onde sai a próxima alocação */
+} Arena;
+
+#define ARENA_BLOCO_MIN ((size_t)16 * 1024)
+#define ARENA_BLOCO_MAX ((size_t)64 * 1024 * 1024)
+
+/* arenaAlocar() – devolve n bytes alinhados; aborta se faltar memória.
+   A etiqueta diz a quem os bytes servem (ver A5_memoria.h). */
+static inline void *arenaAlocar(Arena *a, size_t n, EtiquetaMem e) {
+    const size_t alinhamento = _Alignof(max_align_t);
+    for (BlocoArena *b = a->atual; b; b = b->prox) {
+        uintptr_t ini = (uintptr_t)(b->dados + b->usado);
+        size_t pad = (alinhamento - ini % alinhamento) % alinhamento;
+        if (b->usado + pad + n <= b->capacidade) {
+            a->atual = b;
+            b->usado += pad + n;
+            MEM_ARENA_CONTAR(a, e, n);
+            return (void *)(ini + pad);
+        }
+        /* bloco cheio: segue para o próximo (reaproveitado após reinício) */
+        if (b->prox) b->prox->usado = 0;
+        else         a->atual = b;
+    }
+
+    /* nenhum bloco serve: cria um novo, dobrando o tamanho até o limite */
+    size_t cap = a->atual ? a->atual->capacidade * 2 : ARENA_BLOCO_MIN;
+    if (cap > ARENA_BLOCO_MAX) cap = ARENA_BLOCO_MAX;
+    if (cap < n + alinhamento) cap = n + alinhamento;
+    BlocoArena *novo = (BlocoArena *)memAlocar(MEM_ARENA, sizeof(BlocoArena) + cap);
+    if (!novo) {
+        fprintf(stderr, "Erro: falha ao alocar bloco de memoria (%zu bytes).\n", cap);
+        exit(EXIT_FAILURE);
+    }
+    novo->prox = NULL;
+    novo->capacidade = cap;
+    novo->usado = 0;
+    MEM_ARENA_INICIAR(novo);
+    if (a->atual) a->atual->prox = novo;
+    else          a->primeiro = novo;
+    a->atual = novo;
+    return arenaAlocar(a, n, e);
+}
+
+/* strdup é POSIX; esta versão copia para dentro da arena. */
+static inline char *arenaDuplicaString(Arena *a, const char *s, EtiquetaMem e) {
+    size_t n = strlen(s) + 1;
+    char *copia = (char *)arenaAlocar(a, n, e);
+    EST_REGISTRAR(bytesDuplicaString, n);
+    memcpy(copia, s, n);
+    return copia;
+}
+
+/* arenaReiniciar() – O(1): volta ao primeiro bloco; os demais são
+   reaproveitados conforme a arena volta a crescer. */
+static inline void arenaReiniciar(Arena *a) {
+    MEM_ARENA_DESCONTAR(a);
+    if (!a->primeiro) return;
+    a->primeiro->usado = 0;
+    a->atual = a->primeiro;
+}
+
+/* arenaLiberar() – devolve todos os blocos (poucos e grandes). */
+static inline void arenaLiberar(Arena *a) {
+    BlocoArena *b = a->primeiro;
+    MEM_ARENA_DESCONTAR(a);
+    while (b) {
+        BlocoArena *prox = b->prox;
+        memLiberar(b);
+        b = prox;
+    }
+    a->primeiro = a->atual = NULL;
+}
+
+/* ------------------------ Salas (mapa) ------------------------ */
+typedef struct Sala {
+    const char *nome;        /* na arena do mapa ou na tabela de internação */
+#if defined(DQ_PISTAS_NA_SALA)
+    const char *pista;       /* pista opcional (NULL = sem pista) */
+#elif defined(DQ_PISTAS_POR_NOME)
+    uint32_t idNome;         /* id do nome na tabela de internação */
+    uint32_t pista;          /* id da pista, resolvido em criarSala() (ID_NENHUM se não houver) */
+#endif
+    struct Sala *esq;        /* caminho à esquerda */
+    struct Sala *dir;        /* caminho à direita */
+} Sala;
+
+#ifdef DQ_PISTAS_POR_NOME
+/* fornecidas pelo capítulo (internação e tabela sala -> pista) */
+uint32_t internar(const char *texto);
+const char *textoInterno(uint32_t id);
+const char *pistaDaSala(const char *nomeSala);
+#endif
+
+/* criarSala() – cria um cômodo na arena do mapa. Com DQ_PISTAS_NA_SALA a
+   pista vem por parâmetro (vazia = sem pista); com DQ_PISTAS_POR_NOME nome
+   e pista são internados e a pista sai de pistaDaSala(). O mapa inteiro é
+   liberado de uma vez com arenaLiberar(). */
+#ifdef DQ_PISTAS_NA_SALA
+static inline Sala *criarSala(Arena *a, const char *nome, const char *pista) {
+#else
+static inline Sala *criarSala(Arena *a, const char *nome) {
+#endif
+    Sala *s = (Sala *)arenaAlocar(a, sizeof(Sala), MEM_SALAS);
+    EST_REGISTRAR(bytesCriarSala, sizeof(Sala));
+#if defined(DQ_PISTAS_POR_NOME)
+    s->idNome = internar(nome);
+    s->nome = textoInterno(s->idNome);
+    const char *p = pistaDaSala(nome);
+    s->pista = (p && p[0] != '\0') ? internar(p) : ID_NENHUM;
+#else
+    s->nome = arenaDuplicaString(a, nome, MEM_NOMES);
+#endif
+#ifdef DQ_PISTAS_NA_SALA
+    s->pista = (pista && pista[0] != '\0') ? arenaDuplicaString(a, pista, MEM_TEXTOS) : NULL;
+#endif
+    s->esq = s->dir = NULL;
+    return s;
+}
+
+#ifdef DQ_COM_PISTAS
+/* --------------- Árvore de pistas coletadas (AVL) --------------- */
+/* Ordem alfabética. Com DQ_PISTAS_POR_NOME a chave é a posição alfabética
+   da pista (comparação de inteiros) e o texto, internado ou do caso, não é
+   copiado; senão a chave é o próprio texto, copiado na arena da sessão. */
+typedef struct PistaNode {
+    const char *texto;       /* conteúdo da pista */
+#ifdef DQ_PISTAS_POR_NOME
+    uint32_t pista;          /* id da pista */
+    uint32_t ordem;          /* posição alfabética da pista: chave da árvore */
+#endif
+#ifdef DQ_SUSPEITOS
+    uint32_t suspeito;       /* id do suspeito associado (ID_NENHUM se nenhum) */
+#endif
+    int count;               /* quantas vezes coletada */
+    int altura;              /* altura da subárvore (folha = 1) */
+    struct PistaNode *esq;
+    struct PistaNode *dir;
+} PistaNode;
+
+/* Altura máxima de uma AVL: ~1.44 * log2(n). 96 níveis bastam para
+   qualquer quantidade de nós endereçável. */
+#define ALTURA_MAX_PISTAS 96
+
+static inline int alturaPista(const PistaNode *n) { return n ? n->altura : 0; }
+
+static inline void atualizarAltura(PistaNode *n) {
+    int a = alturaPista(n->esq), b = alturaPista(n->dir);
+    n->altura = 1 + (a > b ? a : b);
+}
+
+static inline PistaNode *rotacionarDireita(PistaNode *y) {
+    PistaNode *x = y->esq;
+    y->esq = x->dir;
+    x->dir = y;
+    atualizarAltura(y);
+    atualizarAltura(x);
+    return x;
+}
+
+static inline PistaNode *rotacionarEsquerda(PistaNode *x) {
+    PistaNode *y = x->dir;
+    x->dir = y->esq;
+    y->esq = x;
+    atualizarAltura(x);
+    atualizarAltura(y);
+    return y;
+}
+
+/* Restaura o fator de balanceamento (-1..1) de n; devolve a nova raiz. */
+static inline PistaNode *balancearPista(PistaNode *n) {
+    atualizarAltura(n);
+    int fb = alturaPista(n->esq) - alturaPista(n->dir);
+    if (fb > 1) {
+        if (alturaPista(n->esq->esq) < alturaPista(n->esq->dir)) n->esq = rotacionarEsquerda(n->esq);
+        return rotacionarDireita(n);
+    }
+    if (fb < -1) {
+        if (alturaPista(n->dir->dir) < alturaPista(n->dir->esq)) n->dir = rotacionarDireita(n->dir);
+        return rotacionarEsquerda(n);
+    }
+    return n;
+}
+
+/* inserirPista() – insere a pista coletada; repetida só soma no contador.
+   Desce guardando o caminho e sobe rebalanceando: O(log n) e profundidade
+   limitada mesmo com pistas chegando já ordenadas. Os nós vêm da arena
+   da sessão. */
+#if defined(DQ_SUSPEITOS)
+static inline void inserirPista(Arena *sessao, PistaNode **raiz, uint32_t pista, uint32_t ordem,
+                                const char *texto, uint32_t suspeito) {
+#elif defined(DQ_PISTAS_POR_NOME)
+static inline void inserirPista(Arena *sessao, PistaNode **raiz, uint32_t pista, uint32_t ordem,
+                                const char *texto) {
+#else
+static inline void inserirPista(Arena *sessao, PistaNode **raiz, const char *texto) {
+#endif
+#ifdef DQ_PISTAS_POR_NOME
+    if (pista == ID_NENHUM) return;
+#endif
+    if (!texto || texto[0] == '\0') return; /* ignora pistas vazias */
+
+    PistaNode **caminho[ALTURA_MAX_PISTAS];
+    int prof = 0;
+    PistaNode **link = raiz;
+    while (*link) {
+#ifdef DQ_PISTAS_POR_NOME
+        int cmp = (ordem > (*link)->ordem) - (ordem < (*link)->ordem);
+#else
+        int cmp = strcmp(texto, (*link)->texto);
+#endif
+        if (cmp == 0) {
+            (*link)->count++;
+            EST_REGISTRAR(profundidadePista, prof);
+            EST_REGISTRAR(comparacoesPista, prof + 1);
+            return;
+        }
+        caminho[prof++] = link;
+        link = (cmp < 0) ? &(*link)->esq : &(*link)->dir;
+    }
+    EST_REGISTRAR(profundidadePista, prof);
+    EST_REGISTRAR(comparacoesPista, prof);
+
+    PistaNode *novo = (PistaNode *)arenaAlocar(sessao, sizeof(PistaNode), MEM_PISTAS);
+#ifdef DQ_PISTAS_POR_NOME
+    novo->texto = texto;
+    novo->pista = pista;
+    novo->ordem = ordem;
+#else
+    novo->texto = arenaDuplicaString(sessao, texto, MEM_TEXTOS);
+#endif
+#ifdef DQ_SUSPEITOS
+    novo->suspeito = suspeito;
+#endif
+    novo->count = 1;
+    novo->altura = 1;
+    novo->esq = novo->dir = NULL;
+    *link = novo;
+
+    /* sobe rebalanceando; se a altura de um nó não muda, os acima também não */
+    while (prof > 0) {
+        PistaNode **l = caminho[--prof];
+        int antes = (*l)->altura;
+        *l = balancearPista(*l);
+        if ((*l)->altura == antes) break;
+    }
+}
+
+/* Iterador em ordem, sem recursão: a pilha guarda os ancestrais ainda não
+   visitados, no máximo a altura da AVL (ALTURA_MAX_PISTAS). Entrega as
+   pistas em lotes, para quem imprime ou agrega muitas de uma vez. */
+typedef struct IteradorPistas {
+    const PistaNode *pilha[ALTURA_MAX_PISTAS];
+    int topo;
+} IteradorPistas;
+
+static inline void descerEsquerda(IteradorPistas *it, const PistaNode *n) {
+    for (; n; n = n->esq) it->pilha[it->topo++] = n;
+}
+
+static inline void iniciarIteradorPistas(IteradorPistas *it, const PistaNode *raiz) {
+    it->topo = 0;
+    descerEsquerda(it, raiz);
+}
+
+/* proximasPistas() – preenche lote[] com até max pistas, na ordem
+   alfabética; devolve quantas (0 = fim). */
+static inline size_t proximasPistas(IteradorPistas *it, const PistaNode **lote, size_t max) {
+    size_t n = 0;
+    while (n < max && it->topo > 0) {
+        const PistaNode *atual = it->pilha[--it->topo];
+        lote[n++] = atual;
+        descerEsquerda(it, atual->dir);
+    }
+    return n;
+}
+
+#define LOTE_PISTAS 64
+
+/* Percorre em ordem, aplicando callback (útil para contagens ou impressão) */
+typedef void (*VisitaPista)(const PistaNode *n, void *udata);
+
+static inline void percorrerInOrder(const PistaNode *r, VisitaPista f, void *udata) {
+    IteradorPistas it;
+    const PistaNode *lote[LOTE_PISTAS];
+    iniciarIteradorPistas(&it, r);
+    for (size_t n; (n = proximasPistas(&it, lote, LOTE_PISTAS)) > 0;) {
+        for (size_t i = 0; i < n; ++i) f(lote[i], udata);
+    }
+}
+
+/* exibirPistas() – imprime a árvore de pistas em ordem alfabética,
+   um lote de cada vez. */
+static inline void exibirPistas(const PistaNode *r) {
+    IteradorPistas it;
+    const PistaNode *lote[LOTE_PISTAS];
+    iniciarIteradorPistas(&it, r);
+    for (size_t n; (n = proximasPistas(&it, lote, LOTE_PISTAS)) > 0;) {
+        for (size_t i = 0; i < n; ++i) {
+            if (lote[i]->count > 1) printf("- %s (x%d)\n", lote[i]->texto, lote[i]->count);
+            else                    printf("- %s\n", lote[i]->texto);
+        }
+    }
+}
+#endif /* DQ_COM_PISTAS */
+
+/* ---------------------------- Saída ---------------------------- */
+/* stdout num buffer próprio de 64 KiB (_IOFBF, também no terminal): só
+   esvazia nas leituras do jogador e no fim do programa, uma escrita por
+   jogada. Tudo que é menu (caminhos, menu principal, prompts) passa por
+   textoMenu(): --silencioso deixa só o jogo. */
+static int silencioso = 0;
+
+static inline void iniciarSaida(void) {
+    static char buffer[1 << 16];
+    setvbuf(stdout, buffer, _IOFBF, sizeof(buffer));
+}
+
+static inline void textoMenu(const char *fmt, ...) {
+    if (silencioso) return;
+    va_list args;
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+}
+
+/* --------------------------- Entrada --------------------------- */
+/* stdin com buffer de 64 KiB (iniciarEntrada), então cada read() traz tudo
+   o que já chegou; lerOpcao() pica uma linha inteira numa fila de comandos
+   e só volta a ler quando ela esvazia. Uma rota colada ("eedds") joga sem
+   leitura nem análise por movimento. Palavra só de e/d/s = uma jogada por
+   letra; palavra só de dígitos ("12") = COMANDO_SAIDA, com o número em
+   numeroComando (saídas numeradas da mansão em grafo); outra palavra
+   ("esquerda", "sair") = a primeira letra; o resto da fila é descartado
+   quando a exploração termina. Um comando que pede texto (lerTexto) leva
+   o resto da linha crua: "i Sala de Estar". */
+#define TAM_LINHA_ENTRADA 4096
+#define COMANDO_SAIDA '#'
+
+static char filaComandos[TAM_LINHA_ENTRADA];
+static uint32_t numerosFila[TAM_LINHA_ENTRADA];  /* número de cada COMANDO_SAIDA */
+static uint32_t numeroComando = 0;               /* o do último entregue por lerOpcao() */
+static char linhaFila[TAM_LINHA_ENTRADA];        /* a linha crua que encheu a fila */
+static uint16_t posicaoFila[TAM_LINHA_ENTRADA];  /* onde cada comando começa nela */
+static size_t inicioFila = 0, fimFila = 0;
+
+static inline void iniciarEntrada(void) {
+    static char buffer[1 << 16];
+    setvbuf(stdin, buffer, _IOFBF, sizeof(buffer));
+}
+
+static inline int letraDeComando(char c) {
+    c = (char)tolower((unsigned char)c);
+    return c == 'e' || c == 'd' || c == 's';
+}
+
+static inline void enfileirarLinha(const char *linha) {
+    inicioFila = fimFila = 0;
+    size_t tam = strlen(linha);
+    if (tam >= sizeof(linhaFila)) tam = sizeof(linhaFila) - 1;
+    memcpy(linhaFila, linha, tam);
+    linhaFila[tam] = '\0';
+    for (const char *p = linha; *p;) {
+        if (isspace((unsigned char)*p)) { ++p; continue; }
+        const char *fim = p;
+        int soComandos = 1, soDigitos = 1;
+        for (; *fim && !isspace((unsigned char)*fim); ++fim) {
+            soComandos &= letraDeComando(*fim);
+            soDigitos &= isdigit((unsigned char)*fim) != 0;
+        }
+        if (soDigitos) {
+            uint32_t n = 0;
+            posicaoFila[fimFila] = (uint16_t)(p - linha);
+            for (; p < fim; ++p) n = (n > 99999999u) ? UINT32_MAX : n * 10 + (uint32_t)(*p - '0');
+            numerosFila[fimFila] = n;
+            filaComandos[fimFila++] = COMANDO_SAIDA;
+            continue;
+        }
+        if (!soComandos) fim = p + 1; /* a palavra vale pela primeira letra */
+        for (; p < fim; ++p) {
+            posicaoFila[fimFila] = (uint16_t)(p - linha);
+            filaComandos[fimFila++] = (char)tolower((unsigned char)*p);
+        }
+        while (*p && !isspace((unsigned char)*p)) ++p;
+    }
+}
+
+/* descartarComandos() – fim da exploração: o resto da linha não vale. */
+static inline void descartarComandos(void) {
+    inicioFila = fimFila = 0;
+    EST_FECHAR_JOGADA();
+}
+
+/* lerOpcao() – próximo comando da fila; só com a fila vazia lê uma linha,
+   descarregando antes o prompt (em pipe ele ficaria preso no buffer).
+   Linha em branco ou EOF valem 's'. */
+static inline char lerOpcao(void) {
+    if (inicioFila == fimFila) fflush(stdout);
+    EST_FECHAR_JOGADA(); /* a jogada anterior acaba com o prompt entregue */
+    EST_ATENDER_PEDIDO();
+    if (inicioFila == fimFila) {
+        char linha[TAM_LINHA_ENTRADA];
+        if (!estLerLinha(linha, sizeof(linha), stdin)) return 's';
+        enfileirarLinha(linha);
+        if (fimFila == 0) return 's';
+    }
+    EST_ABRIR_JOGADA();
+    numeroComando = numerosFila[inicioFila];
+    return filaComandos[inicioFila++];
+}
+
+/* lerTexto() – texto livre depois de um comando (nome de sala): o resto da
+   linha atual, se houver, e a fila termina aí; senão mostra o prompt e lê
+   uma linha nova. Sem o '\n' final; NULL em EOF. */
+static inline char *lerTexto(const char *prompt, char *s, int n) {
+    if (inicioFila < fimFila) {
+        snprintf(s, (size_t)n, "%s", linhaFila + posicaoFila[inicioFila]);
+        inicioFila = fimFila = 0;
+    } else {
+        textoMenu("%s", prompt);
+        fflush(stdout);
+        if (!estLerLinha(s, n, stdin)) return NULL;
+    }
+    s[strcspn(s, "\r\n")] = '\0';
+    return s;
+}
+
+/* lerLinhaLonga() – uma linha inteira de 'in', de qualquer tamanho, em *buf
+   (que cresce com memRealocar; quem chama libera com memLiberar). Sem o
+   '\n' final; NULL em EOF. É o leitor dos roteiros (--replay): um caminho
+   do resolvedor pode ter milhares de movimentos e não pode ser truncado. */
+static inline char *lerLinhaLonga(FILE *in, char **buf, size_t *cap) {
+    size_t tam = 0;
+    for (;;) {
+        if (*cap - tam < 2) {
+            size_t novoCap = *cap ? *cap * 2 : 256;
+            char *novo = (char *)memRealocar(MEM_TEXTOS, *buf, novoCap);
+            if (!novo) {
+                fprintf(stderr, "Erro ao alocar linha de entrada.\n");
+                exit(EXIT_FAILURE);
+            }
+            *buf = novo;
+            *cap = novoCap;
+        }
+        int n = *cap - tam > INT_MAX ? INT_MAX : (int)(*cap - tam);
+        if (!estLerLinha(*buf + tam, n, in)) {
+            if (tam == 0) return NULL;
+            (*buf)[tam] = '\0';          /* última linha, sem '\n' */
+            return *buf;
+        }
+        size_t lidos = strlen(*buf + tam);
+        tam += lidos;
+        if (tam > 0 && (*buf)[tam - 1] == '\n') {
+            (*buf)[--tam] = '\0';
+            return *buf;
+        }
+        if (lidos + 1 < (size_t)n) return *buf;  /* EOF no meio do pedaço */
+    }
+}
+
+#ifndef DQ_PISTAS_POR_NOME
+/* -------------------------- Exportação -------------------------- */
+/* pista de uma sala no escritor: índice no caso ou CASO_NENHUM */
+static inline uint32_t pistaExportada(CasoEscritor *e, const Sala *s) {
+#ifdef DQ_PISTAS_NA_SALA
+    return s->pista ? escritorPista(e, s->pista, NULL) : CASO_NENHUM;
+#else
+    (void)e;
+    (void)s;
+    return CASO_NENHUM;
+#endif
+}
+
+/* exportarCaso() – grava a árvore em formato binário, salas em ordem BFS
+   (o Hall recebe o índice 0). Pistas repetidas viram uma única entrada.
+   Retorna 0 ou -1. (O Mestre grava a sua forma compacta.) */
+static inline int exportarCaso(Sala *raiz, const char *caminho) {
+    CasoEscritor e;
+    memset(&e, 0, sizeof(e));
+    size_t cap = 16, fim = 0;
+    Sala **fila = (Sala **)memAlocar(MEM_TRABALHO, cap * sizeof(Sala *));
+    if (!fila) {
+        fprintf(stderr, "Erro ao alocar fila de exportacao.\n");
+        exit(EXIT_FAILURE);
+    }
+    fila[fim++] = raiz;
+    escritorSala(&e, raiz->nome, pistaExportada(&e, raiz));
+
+    /* o índice de cada sala coincide com sua posição na fila */
+    for (size_t i = 0; i < fim; ++i) {
+        Sala *s = fila[i];
+        if (fim + 2 > cap) {
+            cap *= 2;
+            Sala **nova = (Sala **)memRealocar(MEM_TRABALHO, fila, cap * sizeof(Sala *));
+            if (!nova) {
+                fprintf(stderr, "Erro ao alocar fila de exportacao.\n");
+                exit(EXIT_FAILURE);
+            }
+            fila = nova;
+        }
+        uint32_t ids[2] = { CASO_NENHUM, CASO_NENHUM };
+        Sala *filhos[2] = { s->esq, s->dir };
+        for (int k = 0; k < 2; ++k) {
+            Sala *f = filhos[k];
+            if (!f) continue;
+            uint32_t p = pistaExportada(&e, f);
+            ids[k] = escritorSala(&e, f->nome, p);
+            fila[fim++] = f;
+        }
+        escritorLigar(&e, (uint32_t)i, ids[0], ids[1]);
+    }
+    memLiberar(fila);
+
+    int r = gravarCaso(&e, caminho);
+    liberarEscritor(&e);
+    return r;
+}
+#endif /* !DQ_PISTAS_POR_NOME */
+
+#endif /* A5_DETETIVE_CORE_H */
@@ -1,62 +1,120 @@
+#define _POSIX_C_SOURCE 200809L  /* sigaction (A5_estatisticas.h) */
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <time.h>
+
+#define DQ_PISTAS_POR_NOME     /* pista achada pelo nome da sala, guardada como id */
+#define DQ_SUSPEITOS           /* cada pista coletada aponta o seu suspeito */
+#include "A5_detetiveCore.h"
 
 /* ============================================================
    Detective Quest - Capítulo Final (Salas + Pistas + Julgamento)
    ------------------------------------------------------------
    Requisitos atendidos:
    - Árvore binária de cômodos (mapa fixo).
-   - Pistas associadas por lógica fixa com base no nome da sala.
-   - BST de pistas coletadas (ordem alfabética).
-   - Tabela Hash: pista -> suspeito.
+   - Salas, pistas coletadas e textos em arenas: cada uma é
+     reiniciada ou liberada de uma vez, sem percorrer nós.
+   - Textos internados: cada nome de sala, pista ou suspeito vira um
+     id inteiro na carga; exploração, BST e veredito usam só ids.
+   - Pistas associadas por lógica fixa com base no nome da sala
+     (resolvidas uma vez por sala, na construção do mapa).
+   - BST de pistas coletadas (ordem alfabética, balanceada AVL).
+   - Arena, salas, BST, entrada e saída vêm do núcleo comum
+     (A5_detetiveCore.h) com DQ_PISTAS_POR_NOME e DQ_SUSPEITOS.
+   - Tabela Hash: pista -> suspeito (vetor indexado pelo id da pista;
+     o hash de texto fica na internação, em endereçamento aberto).
    - Exploração interativa (e/d/s), listagem final e acusação.
+   - Roteiros sem terminal (carga, testes): --replay arquivo roda
+     uma sessão por linha e emite um registro compacto por sessão;
+     --threads N divide as sessões entre N threads (roubo de trabalho)
+     que compartilham o mapa e a tabela, só leitura (POSIX;
+     compilar com -pthread).
+   - --resolver: melhor contagem possível por suspeito, se condena e
+     o caminho até ela (programação sobre a árvore, em threads).
+   - --compacto: converte a mansão embutida ou gerada para a forma
+     compacta (vetor de salas em pré-ordem, filhos em 32 bits, textos
+     à parte) e joga, repete e resolve sobre ela; --resolver também
+     aceita --caso.
+   - --dicas: ao lado de cada caminho, os suspeitos que ainda têm
+     pista naquela direção (resumo em bits por subárvore, montado
+     numa varredura linear).
+   - --gerar forma:salas[:semente[:densidade[:suspeitos]]]: mansões
+     balanceadas, degeneradas ou aleatórias, determinísticas, até
+     ~10^8 salas, construídas em paralelo (ver o gerador).
+   - --grafo extras[:semente]: as salas do caso viram um grafo com
+     N saídas por sala (filhos, porta de volta para o pai e passagens
+     extras), em CSR; saídas numeradas e 'v' para voltar.
+   - --viagem: índice nome -> sala e ancestrais por saltos, montados
+     na carga; 'i nome' leva a qualquer sala já visitada, com a rota
+     pelo ancestral comum em O(log n).
    - Verificação automática: pelo menos 2 pistas precisam apontar
-     para o suspeito acusado para condenar.
+     para o suspeito acusado para condenar (contadores por suspeito,
+     atualizados na coleta: veredito e ranking sem percorrer a BST).
+   - Caso externo em formato binário (A5_casoBinario.h):
+       --caso arquivo.dqc           joga o caso mapeado do disco
+       --exportar-caso arquivo.dqc  grava a mansão embutida e sai
+   - Caso em tabelas estáticas geradas (-DDQ_CASO_ESTATICO,
+     A5_casoMansao.h): partida sem alocações nem hashing.
+   - Saída: um buffer para todo o stdout, descarregado antes de cada
+     leitura do jogador e ao sair (uma escrita por jogada); com
+     --silencioso, menus, caminhos e prompts não são impressos.
+   - --stats (com -DDQ_ESTATISTICAS, A5_estatisticas.h): sondagens
+     da internação, BST de pistas, strcmp de pistaDaSala, bytes de
+     criarSala/criarHash/duplicação e tempo por jogada, em JSON no
+     stderr ao sair ou a cada SIGUSR1.
+   - --memoria (com -DDQ_MEMORIA, A5_memoria.h): todo malloc/free
+     etiquetado por subsistema (salas, nomes, pistas, baldes e
+     entradas de hash, textos, caso, apoio), com pico e folga contra
+     o layout compacto; vazamentos sempre acusados ao sair.
    ============================================================ */
 
 /* ========================= Estruturas ========================= */
 
-/* Árvore de Salas (mapa) */
-typedef struct Sala {
-    char *nome;
-    struct Sala *esq;
-    struct Sala *dir;
-} Sala;
-
-/* BST de Pistas Coletadas (ordenadas alfabeticamente) */
-typedef struct PistaNode {
-    char *texto;             /* conteúdo da pista */
-    int count;               /* quantas vezes coletada */
-    struct PistaNode *esq;
-    struct PistaNode *dir;
-} PistaNode;
-
-/* Tabela Hash (encadeamento) para pista -> suspeito */
-typedef struct HashNode {
-    char *chavePista;        /* pista (key) */
-    char *suspeito;          /* suspeito (value) */
-    struct HashNode *prox;
-} HashNode;
+/* Evidências de uma exploração: a BST (para listar) e um contador por
+   suspeito, atualizado a cada coleta (para julgar sem percorrer a BST). */
+typedef struct Evidencias {
+    PistaNode *pistas;
+    int *porSuspeito;        /* id do suspeito -> pistas coletadas contra ele */
+    uint32_t numSuspeitos;   /* ids válidos em porSuspeito: 0..numSuspeitos-1 */
+} Evidencias;
+
+/* Internação de textos: cada texto distinto recebe um id denso (0, 1, 2...)
+   na carga. Índice de endereçamento aberto (Robin Hood); cada slot guarda o
+   hash completo, de modo que o crescimento e a maioria das sondagens não
+   releem a string. */
+typedef struct SlotInterno {
+    uint64_t hash;           /* hashTexto(texto) (cache) */
+    uint32_t id;             /* ID_NENHUM = slot vazio */
+    uint32_t dist;           /* distância até a posição ideal */
+} SlotInterno;
 
+typedef struct TabelaInternos {
+    SlotInterno *slots;
+    size_t capacidade;       /* sempre potência de 2 (0 antes do primeiro uso) */
+    unsigned bits;           /* log2(capacidade) */
+    uint32_t quantidade;     /* ids em uso */
+    uint32_t capIds;         /* capacidade de textos[] e ordem[] */
+    const char **textos;     /* id -> texto (na arena) */
+    uint32_t *ordem;         /* id -> posição alfabética (ver ordenarInternos) */
+    int ordemValida;
+    Arena arena;             /* os textos, uma cópia por id */
+} TabelaInternos;
+
+/* Tabela pista -> suspeito. Com as pistas internadas, é um vetor denso
+   indexado pelo id da pista: a consulta não compara nem hasheia texto. */
 typedef struct HashTable {
+    uint32_t *suspeitoDaPista;   /* id da pista -> id do suspeito (ID_NENHUM = sem) */
     size_t capacidade;
-    HashNode **buckets;
+    size_t quantidade;
 } HashTable;
 
 /* ===================== Utilidades de string ==================== */
 
-/* Implementação própria do strdup para portabilidade */
-static char *duplicaString(const char *s) {
-    if (!s) return NULL;
-    size_t n = strlen(s) + 1;
-    char *p = (char *)malloc(n);
-    if (!p) return NULL;
-    memcpy(p, s, n);
-    return p;
-}
-
 /* Remove newline/espacos finais (qualquer \r\n e espaços) */
 static void rstrip(char *s) {
     if (!s) return;
@@ -66,223 +124,539 @@ static void rstrip(char *s) {
     }
 }
 
-/* ==================== Hash (pista -> suspeito) ==================== */
+/* ==================== Internação de textos ==================== */
 
-/* Hash DJB2 (boa distribuição para strings) */
-static unsigned long djb2(const unsigned char *str) {
-    unsigned long hash = 5381;
-    int c;
-    while ((c = *str++)) {
-        hash = ((hash << 5) + hash) + (unsigned long)c; /* hash * 33 + c */
-    }
-    return hash;
+static uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
 }
 
-HashTable *criarHash(size_t capacidade) {
-    HashTable *ht = (HashTable *)malloc(sizeof(HashTable));
-    if (!ht) {
-        fprintf(stderr, "Erro ao alocar HashTable.\n");
-        exit(EXIT_FAILURE);
+/* hashTexto() – hash de strings que consome 8 bytes por iteração (mistura
+   no estilo MurmurHash3 de 64 bits) e termina com fmix64, de modo que
+   qualquer bit da entrada afeta todos os bits do resultado. Substitui o
+   djb2 byte a byte; o A5_benchDetetive.c compara os dois. */
+static uint64_t hashTexto(const char *str) {
+    const uint64_t c1 = 0x87C37B91114253D5ull, c2 = 0x4CF5AD432745937Full;
+    const unsigned char *p = (const unsigned char *)str;
+    size_t n = strlen(str);
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ (uint64_t)n;
+    uint64_t k;
+
+    for (; n >= 8; p += 8, n -= 8) {
+        memcpy(&k, p, 8); /* leitura não alinhada portável */
+        k *= c1; k = rotl64(k, 31); k *= c2;
+        h ^= k;
+        h = rotl64(h, 27) * 5 + 0x52DCE729;
     }
-    ht->capacidade = capacidade;
-    ht->buckets = (HashNode **)calloc(capacidade, sizeof(HashNode *));
-    if (!ht->buckets) {
-        fprintf(stderr, "Erro ao alocar buckets da HashTable.\n");
-        free(ht);
-        exit(EXIT_FAILURE);
+    if (n) {
+        k = 0;
+        memcpy(&k, p, n);
+        k *= c1; k = rotl64(k, 31); k *= c2;
+        h ^= k;
     }
-    return ht;
+    h ^= h >> 33; h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33; h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
 }
 
-/* inserirNaHash() – insere associação pista/suspeito na tabela hash. */
-void inserirNaHash(HashTable *ht, const char *pista, const char *suspeito) {
-    if (!ht || !pista || !suspeito) return;
-    unsigned long h = djb2((const unsigned char *)pista) % ht->capacidade;
+/* Carga máxima 7/8: acima disso o índice dobra de tamanho. */
+#define HASH_CARGA_NUM 7
+#define HASH_CARGA_DEN 8
 
-    /* Atualiza se já existir mesma chave */
-    for (HashNode *no = ht->buckets[h]; no; no = no->prox) {
-        if (strcmp(no->chavePista, pista) == 0) {
-            /* substitui suspeito */
-            free(no->suspeito);
-            no->suspeito = duplicaString(suspeito);
-            return;
-        }
-    }
-    /* não encontrado: insere novo no início da lista */
-    HashNode *novo = (HashNode *)malloc(sizeof(HashNode));
-    if (!novo) {
-        fprintf(stderr, "Erro ao alocar nó da HashTable.\n");
+/* Única tabela do programa: nomes de salas, pistas e suspeitos. */
+static TabelaInternos internos;
+
+/* Posição ideal: os bits altos do hash (hashTexto tem boa avalanche). */
+static size_t posicaoIdeal(uint64_t h) {
+    return (size_t)(h >> (64 - internos.bits));
+}
+
+static void alocarSlotsInternos(size_t capacidade, unsigned bits) {
+    internos.slots = (SlotInterno *)memAlocar(MEM_BALDES, capacidade * sizeof(SlotInterno));
+    if (!internos.slots) {
+        fprintf(stderr, "Erro ao alocar tabela de internacao.\n");
         exit(EXIT_FAILURE);
     }
-    novo->chavePista = duplicaString(pista);
-    novo->suspeito   = duplicaString(suspeito);
-    novo->prox = ht->buckets[h];
-    ht->buckets[h] = novo;
+    for (size_t i = 0; i < capacidade; ++i) internos.slots[i].id = ID_NENHUM;
+    internos.capacidade = capacidade;
+    internos.bits = bits;
 }
 
-/* encontrarSuspeito() – consulta o suspeito correspondente a uma pista. */
-const char *encontrarSuspeito(HashTable *ht, const char *pista) {
-    if (!ht || !pista) return NULL;
-    unsigned long h = djb2((const unsigned char *)pista) % ht->capacidade;
-    for (HashNode *no = ht->buckets[h]; no; no = no->prox) {
-        if (strcmp(no->chavePista, pista) == 0) {
-            return no->suspeito;
+/* Coloca um slot já preenchido no índice (Robin Hood: quem está mais
+   longe da posição ideal fica com o lugar; o deslocado segue sondando). */
+static void colocarSlot(SlotInterno item) {
+    size_t mask = internos.capacidade - 1;
+    size_t i = posicaoIdeal(item.hash);
+    item.dist = 0;
+    while (internos.slots[i].id != ID_NENHUM) {
+        if (internos.slots[i].dist < item.dist) {
+            SlotInterno tmp = internos.slots[i];
+            internos.slots[i] = item;
+            item = tmp;
         }
+        i = (i + 1) & mask;
+        item.dist++;
     }
-    return NULL;
+    internos.slots[i] = item;
 }
 
-void liberarHash(HashTable *ht) {
-    if (!ht) return;
-    for (size_t i = 0; i < ht->capacidade; ++i) {
-        HashNode *no = ht->buckets[i];
-        while (no) {
-            HashNode *prox = no->prox;
-            free(no->chavePista);
-            free(no->suspeito);
-            free(no);
-            no = prox;
+/* Dobra a capacidade, reposicionando pelos hashes em cache. */
+static void crescerInternos(void) {
+    SlotInterno *velhos = internos.slots;
+    size_t capVelha = internos.capacidade;
+    alocarSlotsInternos(capVelha ? capVelha << 1 : 64, capVelha ? internos.bits + 1 : 6);
+    for (size_t i = 0; i < capVelha; ++i) {
+        if (velhos[i].id != ID_NENHUM) colocarSlot(velhos[i]);
+    }
+    memLiberar(velhos);
+}
+
+/* buscarInternoComHash() – id do texto (hash já calculado) ou ID_NENHUM.
+   A sondagem para assim que a distância do slot for menor que a nossa
+   (invariante Robin Hood); strcmp só quando o hash de 64 bits bate. */
+uint32_t buscarInternoComHash(const char *texto, uint64_t h) {
+    if (!texto || internos.capacidade == 0) return ID_NENHUM;
+    size_t mask = internos.capacidade - 1;
+    size_t i = posicaoIdeal(h);
+    for (uint32_t dist = 0;; ++dist, i = (i + 1) & mask) {
+        const SlotInterno *s = &internos.slots[i];
+        if (s->id == ID_NENHUM || s->dist < dist) {
+            EST_REGISTRAR(sondagensInterno, dist + 1);
+            return ID_NENHUM;
+        }
+        if (s->hash == h && strcmp(internos.textos[s->id], texto) == 0) {
+            EST_REGISTRAR(sondagensInterno, dist + 1);
+            return s->id;
         }
     }
-    free(ht->buckets);
-    free(ht);
 }
 
-/* ==================== BST de pistas coletadas ==================== */
+uint32_t buscarInterno(const char *texto) {
+    return texto ? buscarInternoComHash(texto, hashTexto(texto)) : ID_NENHUM;
+}
+
+/* internar() – devolve o id do texto, criando-o (e guardando uma cópia)
+   na primeira vez. Chamado só na carga; depois disso tudo é por id. */
+uint32_t internar(const char *texto) {
+    if (!texto) return ID_NENHUM;
+    uint64_t h = hashTexto(texto);
+    uint32_t id = buscarInternoComHash(texto, h);
+    if (id != ID_NENHUM) return id;
 
-/* inserirPista() / adicionarPista() – insere a pista coletada na BST. */
-void inserirPista(PistaNode **raiz, const char *texto) {
-    if (!texto || texto[0] == '\0') return;
-    if (*raiz == NULL) {
-        PistaNode *novo = (PistaNode *)malloc(sizeof(PistaNode));
-        if (!novo) {
-            fprintf(stderr, "Erro ao alocar nó de pista.\n");
+    if (((size_t)internos.quantidade + 1) * HASH_CARGA_DEN > internos.capacidade * HASH_CARGA_NUM) {
+        crescerInternos();
+    }
+    if (internos.quantidade == internos.capIds) {
+        uint32_t cap = internos.capIds ? internos.capIds * 2 : 64;
+        const char **t = (const char **)memRealocar(MEM_ENTRADAS, (void *)internos.textos, cap * sizeof(char *));
+        uint32_t *o = t ? (uint32_t *)memRealocar(MEM_ENTRADAS, internos.ordem, cap * sizeof(uint32_t)) : NULL;
+        if (!t || !o) {
+            fprintf(stderr, "Erro ao alocar textos internados.\n");
             exit(EXIT_FAILURE);
         }
-        novo->texto = duplicaString(texto);
-        if (!novo->texto) {
-            fprintf(stderr, "Erro ao alocar texto da pista.\n");
-            free(novo);
+        internos.textos = t;
+        internos.ordem = o;
+        internos.capIds = cap;
+    }
+
+    id = internos.quantidade++;
+    internos.textos[id] = arenaDuplicaString(&internos.arena, texto, MEM_TEXTOS);
+    internos.ordemValida = 0;
+    SlotInterno novo = { h, id, 0 };
+    colocarSlot(novo);
+    return id;
+}
+
+/* textoInterno() – texto de um id (NULL para ID_NENHUM). */
+const char *textoInterno(uint32_t id) {
+    return (id < internos.quantidade) ? internos.textos[id] : NULL;
+}
+
+static int compararInternos(const void *a, const void *b) {
+    return strcmp(internos.textos[*(const uint32_t *)a], internos.textos[*(const uint32_t *)b]);
+}
+
+/* ordenarInternos() – calcula a posição alfabética de cada id, para que a
+   árvore de pistas ordene comparando inteiros. Chamada ao fim da carga
+   (ou sob demanda, se algo foi internado depois). */
+void ordenarInternos(void) {
+    if (internos.ordemValida || internos.quantidade == 0) return;
+    uint32_t *ids = (uint32_t *)memAlocar(MEM_TRABALHO, internos.quantidade * sizeof(uint32_t));
+    if (!ids) {
+        fprintf(stderr, "Erro ao ordenar textos internados.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t i = 0; i < internos.quantidade; ++i) ids[i] = i;
+    qsort(ids, internos.quantidade, sizeof(uint32_t), compararInternos);
+    for (uint32_t k = 0; k < internos.quantidade; ++k) internos.ordem[ids[k]] = k;
+    memLiberar(ids);
+    internos.ordemValida = 1;
+}
+
+static uint32_t ordemInterna(uint32_t id) {
+    if (!internos.ordemValida) ordenarInternos();
+    return internos.ordem[id];
+}
+
+void liberarInternos(void) {
+    memLiberar(internos.slots);
+    memLiberar((void *)internos.textos);
+    memLiberar(internos.ordem);
+    arenaLiberar(&internos.arena);
+    memset(&internos, 0, sizeof(internos));
+}
+
+/* ==================== Tabela pista -> suspeito ==================== */
+
+/* criarHash() – reserva espaço para ids de pista até a capacidade pedida;
+   cresce sozinha se vierem mais. */
+HashTable *criarHash(size_t capacidade) {
+    HashTable *ht = (HashTable *)memAlocar(MEM_ENTRADAS, sizeof(HashTable));
+    if (!ht) {
+        fprintf(stderr, "Erro ao alocar HashTable.\n");
+        exit(EXIT_FAILURE);
+    }
+    ht->capacidade = 0;
+    ht->quantidade = 0;
+    ht->suspeitoDaPista = NULL;
+    if (capacidade) {
+        ht->suspeitoDaPista = (uint32_t *)memAlocar(MEM_BALDES, capacidade * sizeof(uint32_t));
+        if (!ht->suspeitoDaPista) {
+            fprintf(stderr, "Erro ao alocar HashTable.\n");
             exit(EXIT_FAILURE);
         }
-        novo->count = 1;
-        novo->esq = novo->dir = NULL;
-        *raiz = novo;
-        return;
+        for (size_t i = 0; i < capacidade; ++i) ht->suspeitoDaPista[i] = ID_NENHUM;
+        ht->capacidade = capacidade;
     }
-    int cmp = strcmp(texto, (*raiz)->texto);
-    if (cmp == 0) {
-        (*raiz)->count++;
-    } else if (cmp < 0) {
-        inserirPista(&(*raiz)->esq, texto);
-    } else {
-        inserirPista(&(*raiz)->dir, texto);
+    EST_REGISTRAR(bytesCriarHash, sizeof(HashTable) + capacidade * sizeof(uint32_t));
+    return ht;
+}
+
+static void garantirPista(HashTable *ht, uint32_t idPista) {
+    if (idPista < ht->capacidade) return;
+    size_t cap = ht->capacidade ? ht->capacidade : 64;
+    while (cap <= idPista) cap *= 2;
+    uint32_t *v = (uint32_t *)memRealocar(MEM_BALDES, ht->suspeitoDaPista, cap * sizeof(uint32_t));
+    if (!v) {
+        fprintf(stderr, "Erro ao alocar HashTable.\n");
+        exit(EXIT_FAILURE);
     }
+    for (size_t i = ht->capacidade; i < cap; ++i) v[i] = ID_NENHUM;
+    ht->suspeitoDaPista = v;
+    ht->capacidade = cap;
+}
+
+/* inserirNaHash() – insere associação pista/suspeito na tabela hash
+   (os dois textos são internados; uma segunda chamada substitui). */
+void inserirNaHash(HashTable *ht, const char *pista, const char *suspeito) {
+    if (!ht || !pista || !suspeito) return;
+    uint32_t idPista = internar(pista);
+    uint32_t idSuspeito = internar(suspeito);
+    garantirPista(ht, idPista);
+    if (ht->suspeitoDaPista[idPista] == ID_NENHUM) ht->quantidade++;
+    ht->suspeitoDaPista[idPista] = idSuspeito;
+}
+
+/* encontrarSuspeitoId() – consulta por id: um acesso a vetor. */
+uint32_t encontrarSuspeitoId(const HashTable *ht, uint32_t idPista) {
+    if (!ht || idPista >= ht->capacidade) return ID_NENHUM;
+    return ht->suspeitoDaPista[idPista];
+}
+
+/* encontrarSuspeito() – consulta o suspeito correspondente a uma pista. */
+const char *encontrarSuspeito(HashTable *ht, const char *pista) {
+    return textoInterno(encontrarSuspeitoId(ht, buscarInterno(pista)));
 }
 
-/* Percorre em ordem, aplicando callback (útil para contagens ou impressão) */
-typedef void (*VisitaPista)(const PistaNode *n, void *udata);
+/* Mesma consulta, com o hash da pista já calculado. */
+const char *encontrarSuspeitoComHash(HashTable *ht, const char *pista, uint64_t h) {
+    return textoInterno(encontrarSuspeitoId(ht, buscarInternoComHash(pista, h)));
+}
+
+void liberarHash(HashTable *ht) {
+    if (!ht) return;
+    memLiberar(ht->suspeitoDaPista);
+    memLiberar(ht);
+}
+
+/* ===================== Evidências da exploração ===================== */
+
+/* iniciarEvidencias() – zera BST e contadores para uma nova exploração.
+   numIds: quantos ids de suspeito existem (no caso carregado, o número de
+   suspeitos; na mansão embutida, todos os textos internados). */
+void iniciarEvidencias(Arena *sessao, Evidencias *ev, uint32_t numIds) {
+    ev->pistas = NULL;
+    ev->numSuspeitos = numIds;
+    ev->porSuspeito = numIds ? (int *)arenaAlocar(sessao, numIds * sizeof(int), MEM_PISTAS) : NULL;
+    if (numIds) memset(ev->porSuspeito, 0, numIds * sizeof(int));
+}
 
-void percorrerInOrder(const PistaNode *r, VisitaPista f, void *udata) {
-    if (!r) return;
-    percorrerInOrder(r->esq, f, udata);
-    f(r, udata);
-    percorrerInOrder(r->dir, f, udata);
+/* registrarPista() – coleta: insere na BST e soma 1 ao suspeito da pista. */
+void registrarPista(Arena *sessao, Evidencias *ev, uint32_t pista, uint32_t ordem,
+                    const char *texto, uint32_t suspeito) {
+    if (pista == ID_NENHUM || !texto || texto[0] == '\0') return;
+    inserirPista(sessao, &ev->pistas, pista, ordem, texto, suspeito);
+    if (suspeito < ev->numSuspeitos) ev->porSuspeito[suspeito]++;
 }
 
-/* exibirPistas() – imprime a árvore de pistas em ordem alfabética. */
-void exibirPistas(const PistaNode *r) {
-    if (!r) return;
-    exibirPistas(r->esq);
-    if (r->count > 1) printf("- %s (x%d)\n", r->texto, r->count);
-    else              printf("- %s\n", r->texto);
-    exibirPistas(r->dir);
+/* pistasContra() – veredito de qualquer suspeito em O(1). */
+int pistasContra(const Evidencias *ev, uint32_t suspeito) {
+    return (suspeito < ev->numSuspeitos) ? ev->porSuspeito[suspeito] : 0;
 }
 
-void liberarBST(PistaNode *r) {
-    if (!r) return;
-    liberarBST(r->esq);
-    liberarBST(r->dir);
-    free(r->texto);
-    free(r);
+/* rankingSuspeitos() – escreve em saida[] os ids com ao menos uma pista,
+   do mais para o menos apontado (empate: menor id primeiro), e devolve
+   quantos são. saida precisa de ev->numSuspeitos posições. */
+uint32_t rankingSuspeitos(const Evidencias *ev, uint32_t *saida) {
+    uint32_t n = 0;
+    for (uint32_t id = 0; id < ev->numSuspeitos; ++id) {
+        int c = ev->porSuspeito[id];
+        if (c == 0) continue;
+        uint32_t j = n++;
+        /* inserção: só entram suspeitos com pista, poucos por exploração */
+        while (j > 0 && ev->porSuspeito[saida[j - 1]] < c) {
+            saida[j] = saida[j - 1];
+            --j;
+        }
+        saida[j] = id;
+    }
+    return n;
 }
 
 /* ====================== Árvore de Salas (mapa) ====================== */
 
-/* criarSala() – cria dinamicamente um cômodo. */
-Sala *criarSala(const char *nome) {
-    Sala *s = (Sala *)malloc(sizeof(Sala));
-    if (!s) {
-        fprintf(stderr, "Erro ao alocar sala \"%s\".\n", nome);
-        exit(EXIT_FAILURE);
+/* Lógica fixa: tabela sala -> pista. Você pode ajustar livremente os
+   textos e quantidades. Alguns compartilham o mesmo suspeito (ver tabela
+   hash). Salas ausentes da tabela não têm pista. */
+typedef struct {
+    const char *sala;
+    const char *pista;
+} PistaPorSala;
+
+static const PistaPorSala PISTAS_POR_SALA[] = {
+    { "Hall de Entrada", "Pegadas de lama" },
+    { "Sala de Estar",   "Almofada fora do lugar" },
+    { "Corredor",        "Perfume forte" },
+    { "Biblioteca",      "Livro raro deslocado" },
+    { "Cozinha",         NULL },
+    { "Escritorio",      "Janela entreaberta" },
+    { "Jardim",          "Luva de couro" },
+    { "Adega",           "Taça com batom" },
+    { "Deposito",        NULL },
+    { "Despensa",        "Rastro de acucar" },
+    { "Estufa",          "Terra revolvida" },
+};
+
+#define NUM_PISTAS_POR_SALA (sizeof(PISTAS_POR_SALA) / sizeof(PISTAS_POR_SALA[0]))
+#define CAP_INDICE_SALAS    (2 * NUM_PISTAS_POR_SALA + 1)
+
+/* Índice de endereçamento aberto sobre a tabela (posição + 1; 0 = vazio),
+   montado na primeira consulta. Carga <= 50%: em média uma comparação. */
+static unsigned indiceSalas[CAP_INDICE_SALAS];
+static int indiceSalasPronto = 0;
+
+static void montarIndiceSalas(void) {
+    for (unsigned i = 0; i < NUM_PISTAS_POR_SALA; ++i) {
+        size_t h = hashTexto(PISTAS_POR_SALA[i].sala) % CAP_INDICE_SALAS;
+        while (indiceSalas[h]) h = (h + 1) % CAP_INDICE_SALAS;
+        indiceSalas[h] = i + 1;
     }
-    s->nome = duplicaString(nome);
-    if (!s->nome) {
-        fprintf(stderr, "Erro ao alocar nome da sala.\n");
-        free(s);
+    indiceSalasPronto = 1;
+}
+
+/* pistaDaSala() – dada uma sala, retorna a pista (ou NULL se não houver).
+   Usada só na construção do mapa: durante a exploração o id da pista já
+   está em Sala::pista, sem nenhuma comparação de strings. */
+const char *pistaDaSala(const char *nomeSala) {
+    if (!indiceSalasPronto) montarIndiceSalas();
+    size_t h = hashTexto(nomeSala) % CAP_INDICE_SALAS;
+    EST_LOCAL(comparacoes);
+    for (unsigned pos; (pos = indiceSalas[h]) != 0; h = (h + 1) % CAP_INDICE_SALAS) {
+        EST_INC(comparacoes);
+        if (strcmp(PISTAS_POR_SALA[pos - 1].sala, nomeSala) == 0) {
+            EST_REGISTRAR(strcmpPistaDaSala, comparacoes);
+            return PISTAS_POR_SALA[pos - 1].pista;
+        }
+    }
+    EST_REGISTRAR(strcmpPistaDaSala, comparacoes);
+    return NULL;
+}
+
+/* ===================== Viagem rápida (--viagem) ===================== */
+/* Montados uma vez na carga, sobre os índices do caso:
+   - índice nome -> sala: endereçamento aberto, carga <= 50%; cada slot
+     guarda a sala e 32 bits do hash, então uma sondagem que não é a
+     certa quase nunca lê o nome. Nomes repetidos ficam com a primeira
+     sala em BFS (a mais perto do Hall).
+   - ancestrais: pai, profundidade e um ponteiro de salto por sala (saltos
+     de Myers): o salto de x é salto(salto(pai)) quando os dois últimos
+     saltos do pai cobrem a mesma distância, senão o próprio pai. Subir
+     até qualquer ancestral custa O(log n) passos, como em binary lifting,
+     mas com 12 bytes por sala em vez de uma tabela de log n níveis (em
+     10^7 salas, ~120 MB contra ~1 GB).
+   A rota até uma sala já visitada sobe até o ancestral comum e desce:
+   passos = prof(a) + prof(b) - 2 prof(ancestral). */
+
+typedef struct SlotNomeSala {
+    uint32_t sala;               /* CASO_NENHUM = slot vazio */
+    uint32_t marca;              /* 32 bits altos de hashTexto(nome) */
+} SlotNomeSala;
+
+typedef struct Viagem {
+    SlotNomeSala *slots;
+    size_t mascara;              /* capacidade - 1 (potência de 2) */
+    uint32_t *pai;               /* CASO_NENHUM no Hall e em salas inalcançáveis */
+    uint32_t *salto;
+    uint32_t *prof;
+} Viagem;
+
+/* montarViagem() – BFS a partir do Hall: cada sala chega depois do pai,
+   então o salto dela sai do salto do pai já pronto; na mesma ordem os
+   nomes entram no índice. */
+void montarViagem(const CasoBinario *c, Viagem *v) {
+    uint32_t N = c->numSalas;
+    size_t cap = 16;
+    while (cap < 2 * (size_t)N) cap <<= 1;
+    v->mascara = cap - 1;
+    v->slots = (SlotNomeSala *)memAlocar(MEM_BALDES, cap * sizeof(SlotNomeSala));
+    v->pai = (uint32_t *)memAlocar(MEM_SALAS, (size_t)N * sizeof(uint32_t));
+    v->salto = (uint32_t *)memAlocar(MEM_SALAS, (size_t)N * sizeof(uint32_t));
+    v->prof = (uint32_t *)memZerada(MEM_SALAS, N, sizeof(uint32_t));
+    uint32_t *fila = (uint32_t *)memAlocar(MEM_TRABALHO, (size_t)N * sizeof(uint32_t));
+    if (!v->slots || !v->pai || !v->salto || !v->prof || !fila) {
+        fprintf(stderr, "Erro ao alocar indices de viagem.\n");
         exit(EXIT_FAILURE);
     }
-    s->esq = s->dir = NULL;
-    return s;
+    for (size_t i = 0; i < cap; ++i) v->slots[i].sala = CASO_NENHUM;
+    for (uint32_t i = 0; i < N; ++i) {
+        v->pai[i] = CASO_NENHUM;
+        v->salto[i] = i;
+    }
+
+    size_t ini = 0, fim = 0;
+    if (N) fila[fim++] = 0;
+    while (ini < fim) {
+        uint32_t s = fila[ini++];
+        const char *nome = casoNomeSala(c, s);
+        uint64_t h = hashTexto(nome);
+        size_t pos = (size_t)h & v->mascara;
+        int repetido = 0;
+        for (; v->slots[pos].sala != CASO_NENHUM && !repetido; pos = (pos + 1) & v->mascara) {
+            repetido = v->slots[pos].marca == (uint32_t)(h >> 32) &&
+                       strcmp(casoNomeSala(c, v->slots[pos].sala), nome) == 0;
+        }
+        if (!repetido) v->slots[pos] = (SlotNomeSala){ s, (uint32_t)(h >> 32) };
+
+        uint32_t filhos[2] = { casoEsq(c, s), casoDir(c, s) };
+        for (int k = 0; k < 2; ++k) {
+            uint32_t f = filhos[k];
+            if (f == CASO_NENHUM || f == 0 || v->pai[f] != CASO_NENHUM) continue;
+            uint32_t j = v->salto[s];
+            v->pai[f] = s;
+            v->prof[f] = v->prof[s] + 1;
+            v->salto[f] = (v->prof[s] - v->prof[j] == v->prof[j] - v->prof[v->salto[j]]) ? v->salto[j] : s;
+            fila[fim++] = f;
+        }
+    }
+    memLiberar(fila);
 }
 
-void liberarArvoreSalas(Sala *r) {
-    if (!r) return;
-    liberarArvoreSalas(r->esq);
-    liberarArvoreSalas(r->dir);
-    free(r->nome);
-    free(r);
+void liberarViagem(Viagem *v) {
+    memLiberar(v->slots);
+    memLiberar(v->pai);
+    memLiberar(v->salto);
+    memLiberar(v->prof);
+    memset(v, 0, sizeof(*v));
 }
 
-/* Lógica fixa: dada uma sala, retorna a pista (ou NULL se não houver). */
-const char *pistaDaSala(const char *nomeSala) {
-    /* Você pode ajustar livremente os textos e quantidades.
-       Alguns compartilham o mesmo suspeito (ver tabela hash). */
-    if (strcmp(nomeSala, "Hall de Entrada") == 0) return "Pegadas de lama";
-    if (strcmp(nomeSala, "Sala de Estar") == 0)   return "Almofada fora do lugar";
-    if (strcmp(nomeSala, "Corredor") == 0)        return "Perfume forte";
-    if (strcmp(nomeSala, "Biblioteca") == 0)      return "Livro raro deslocado";
-    if (strcmp(nomeSala, "Cozinha") == 0)         return NULL;
-    if (strcmp(nomeSala, "Escritorio") == 0)      return "Janela entreaberta";
-    if (strcmp(nomeSala, "Jardim") == 0)          return "Luva de couro";
-    if (strcmp(nomeSala, "Adega") == 0)           return "Taça com batom";
-    if (strcmp(nomeSala, "Deposito") == 0)        return NULL;
-    if (strcmp(nomeSala, "Despensa") == 0)        return "Rastro de acucar";
-    if (strcmp(nomeSala, "Estufa") == 0)          return "Terra revolvida";
-    return NULL;
+/* salaPeloNome() – índice da sala com esse nome, ou CASO_NENHUM. */
+static uint32_t salaPeloNome(const CasoBinario *c, const Viagem *v, const char *nome) {
+    uint64_t h = hashTexto(nome);
+    for (size_t pos = (size_t)h & v->mascara; v->slots[pos].sala != CASO_NENHUM; pos = (pos + 1) & v->mascara) {
+        const SlotNomeSala *s = &v->slots[pos];
+        if (s->marca == (uint32_t)(h >> 32) && strcmp(casoNomeSala(c, s->sala), nome) == 0) return s->sala;
+    }
+    return CASO_NENHUM;
 }
 
-/* ================== Exploração + coleta de pistas ================== */
+/* ancestralComum() – iguala as profundidades e sobe as duas salas juntas,
+   pelo salto quando ele não passa do ponto de encontro. Como o salto
+   depende só da profundidade, na mesma profundidade os dois saltos chegam
+   ao mesmo nível. */
+static uint32_t ancestralComum(const Viagem *v, uint32_t a, uint32_t b) {
+    if (v->prof[a] < v->prof[b]) { uint32_t t = a; a = b; b = t; }
+    while (v->prof[a] > v->prof[b]) a = (v->prof[v->salto[a]] >= v->prof[b]) ? v->salto[a] : v->pai[a];
+    while (a != b) {
+        if (v->salto[a] != v->salto[b]) { a = v->salto[a]; b = v->salto[b]; }
+        else                            { a = v->pai[a];   b = v->pai[b]; }
+    }
+    return a;
+}
+
+/* Salas já visitadas numa exploração: um bit por sala, na arena da sessão. */
+static uint8_t *criarVisitadas(Arena *sessao, const Viagem *v, const CasoBinario *c) {
+    if (!v) return NULL;
+    size_t n = ((size_t)c->numSalas + 7) / 8;
+    uint8_t *bits = (uint8_t *)arenaAlocar(sessao, n ? n : 1, MEM_TRABALHO);
+    memset(bits, 0, n ? n : 1);
+    return bits;
+}
+
+static int foiVisitada(const uint8_t *visitadas, uint32_t s) {
+    return (visitadas[s / 8] >> (s % 8)) & 1;
+}
+
+static void marcarVisitada(uint8_t *visitadas, uint32_t s) {
+    if (visitadas) visitadas[s / 8] |= (uint8_t)(1u << (s % 8));
+}
 
-/* Ler primeira letra não-espaço e normalizar */
-static char lerOpcao() {
-    char buf[64];
-    if (!fgets(buf, sizeof(buf), stdin)) return 's';
-    for (size_t i = 0; buf[i]; ++i) {
-        if (!isspace((unsigned char)buf[i])) return (char)tolower((unsigned char)buf[i]);
+/* pedirViagem() – comando 'i': lê o nome, confere que a sala já foi
+   visitada e anuncia a rota; devolve a sala de destino ou CASO_NENHUM. */
+static uint32_t pedirViagem(const CasoBinario *c, const Viagem *v, const uint8_t *visitadas, uint32_t atual) {
+    char nome[TAM_LINHA_ENTRADA];
+    if (!lerTexto("Ir para (nome da sala): ", nome, sizeof(nome))) return CASO_NENHUM;
+    rstrip(nome);
+    uint32_t destino = salaPeloNome(c, v, nome);
+    if (destino == CASO_NENHUM) {
+        printf("Nao ha sala chamada \"%s\".\n", nome);
+        return CASO_NENHUM;
+    }
+    if (!foiVisitada(visitadas, destino)) {
+        printf("Voce ainda nao passou por \"%s\".\n", nome);
+        return CASO_NENHUM;
     }
-    return 's';
+    if ((destino && v->pai[destino] == CASO_NENHUM) || (atual && v->pai[atual] == CASO_NENHUM)) {
+        printf("Nao ha rota pela mansao ate \"%s\".\n", nome); /* sala fora da árvore do Hall */
+        return CASO_NENHUM;
+    }
+    uint32_t via = ancestralComum(v, atual, destino);
+    printf("Viagem rapida: %s -> %s (%u passos, via %s)\n", casoNomeSala(c, atual), nome,
+           v->prof[atual] + v->prof[destino] - 2 * v->prof[via], casoNomeSala(c, via));
+    return destino;
 }
 
+/* ================== Exploração + coleta de pistas ================== */
+
 /* explorarSalas() – navega pela árvore e ativa o sistema de pistas.
    - Exibe sala atual, mostra/insere pista (BST) e informa suspeito (hash).
    - Caminhos: e/d/s. Exploração termina em 's'. */
-void explorarSalas(Sala *hall, PistaNode **pistas, HashTable *mapaPistaSuspeito) {
+void explorarSalas(Arena *sessao, Sala *hall, Evidencias *ev, HashTable *mapaPistaSuspeito) {
     if (!hall) { printf("Mapa inexistente.\n"); return; }
 
     Sala *atual = hall;
-    printf("\n==============================================\n");
-    printf("    Detective Quest - Exploracao Final        \n");
-    printf("==============================================\n");
+    textoMenu("\n==============================================\n");
+    textoMenu("    Detective Quest - Exploracao Final        \n");
+    textoMenu("==============================================\n");
 
     while (1) {
         printf("\nVoce esta em: %s\n", atual->nome);
 
         /* Coleta da pista da sala (se houver) */
-        const char *p = pistaDaSala(atual->nome);
-        if (p && p[0] != '\0') {
-            inserirPista(pistas, p);
-            const char *sus = encontrarSuspeito(mapaPistaSuspeito, p);
+        if (atual->pista != ID_NENHUM) {
+            const char *p = textoInterno(atual->pista);
+            uint32_t idSus = encontrarSuspeitoId(mapaPistaSuspeito, atual->pista);
+            const char *sus = textoInterno(idSus);
+            registrarPista(sessao, ev, atual->pista, ordemInterna(atual->pista), p, idSus);
             if (sus) {
                 printf("Pista encontrada: \"%s\" -> suspeito associado: %s\n", p, sus);
             } else {
@@ -293,11 +667,11 @@ void explorarSalas(Sala *hall, PistaNode **pistas, HashTable *mapaPistaSuspeito)
         }
 
         /* Opções de navegação */
-        printf("\nCaminhos disponiveis a partir de \"%s\":\n", atual->nome);
-        if (atual->esq) printf("  (e) Esquerda: %s\n", atual->esq->nome);
-        if (atual->dir) printf("  (d) Direita : %s\n", atual->dir->nome);
-        printf("  (s) Sair da exploracao\n");
-        printf("Escolha [e/d/s]: ");
+        textoMenu("\nCaminhos disponiveis a partir de \"%s\":\n", atual->nome);
+        if (atual->esq) textoMenu("  (e) Esquerda: %s\n", atual->esq->nome);
+        if (atual->dir) textoMenu("  (d) Direita : %s\n", atual->dir->nome);
+        textoMenu("  (s) Sair da exploracao\n");
+        textoMenu("Escolha [e/d/s]: ");
 
         char op = lerOpcao();
         if (op == 's') {
@@ -313,36 +687,209 @@ void explorarSalas(Sala *hall, PistaNode **pistas, HashTable *mapaPistaSuspeito)
             printf("Opcao invalida. Use 'e', 'd' ou 's'.\n");
         }
     }
+    descartarComandos();
 }
 
-/* ========================== Julgamento ========================== */
+/* ---------------- Resumo das subárvores (--dicas) ----------------
+   Para cada sala, o conjunto dos suspeitos com alguma pista na subárvore
+   dela (a própria sala incluída), em bits: um uint64_t por sala até 64
+   suspeitos, mais palavras só quando há mais. Com o resumo pronto, a dica
+   de cada caminho na tela é uma consulta por filho.
+   Em pré-ordem ou BFS o filho vem depois do pai, e o resumo inteiro sai
+   de uma varredura de trás para frente, sequencial:
+       resumo(i) = suspeito(i) | resumo(esq) | resumo(dir)
+   Um caso gravado em outra ordem cai numa pós-ordem iterativa, que termina
+   porque abrirCaso() só aceita salas em árvore (casoValidarArvore). */
+typedef struct ResumoSuspeitos {
+    uint64_t *bits;              /* (numSalas + 1) x palavras; a última linha é zero */
+    uint32_t palavras;           /* ceil(numSuspeitos / 64) */
+} ResumoSuspeitos;
 
-/* Estrutura auxiliar para contagem por suspeito */
-typedef struct {
-    const HashTable *ht;
-    const char *acusado;
-    int total; /* total de pistas coletadas que mapeiam para o acusado */
-} ContadorSuspeitoCtx;
+static uint64_t *resumoDaSala(const ResumoSuspeitos *r, uint32_t sala) {
+    return r->bits + (size_t)sala * r->palavras;
+}
+
+/* resumo(i) = suspeito(i) | resumo(filhos); os filhos já estão prontos.
+   Filho ausente lê a linha extra de zeros (índice numSalas), sem desvio. */
+static void juntarResumo(const CasoBinario *c, ResumoSuspeitos *r, uint32_t i) {
+    const CasoSala *s = &c->salas[i];
+    uint32_t N = c->numSalas;
+    const uint64_t *e = resumoDaSala(r, s->esq < N ? s->esq : N);
+    const uint64_t *d = resumoDaSala(r, s->dir < N ? s->dir : N);
+    uint64_t *o = resumoDaSala(r, i);
+    for (uint32_t w = 0; w < r->palavras; ++w) o[w] = e[w] | d[w];
+    uint32_t p = casoPistaIdx(c, i), sus = (p == CASO_NENHUM) ? CASO_NENHUM : casoSuspeitoIdx(c, p);
+    if (sus != CASO_NENHUM) o[sus / 64] |= 1ull << (sus % 64);
+}
+
+void montarResumo(const CasoBinario *c, ResumoSuspeitos *r) {
+    r->palavras = (c->numSuspeitos + 63) / 64;
+    if (r->palavras == 0) r->palavras = 1;
+    r->bits = (uint64_t *)memZerada(MEM_TRABALHO, ((size_t)c->numSalas + 1) * r->palavras, sizeof(uint64_t));
+    if (!r->bits) {
+        fprintf(stderr, "Erro ao alocar resumo das salas.\n");
+        exit(EXIT_FAILURE);
+    }
+    int emOrdem = 1;
+    for (uint32_t i = 0; i < c->numSalas; ++i) {
+        uint32_t esq = c->salas[i].esq, dir = c->salas[i].dir;
+        emOrdem &= (esq >= c->numSalas || esq > i) & (dir >= c->numSalas || dir > i);
+    }
+    if (emOrdem) {
+        for (uint32_t i = c->numSalas; i-- > 0;) juntarResumo(c, r, i);
+    } else {
+        /* pós-ordem iterativa: bit 31 marca "filhos já empilhados" */
+        size_t cap = 1024, topo = 0;
+        uint32_t *pilha = (uint32_t *)memAlocar(MEM_TRABALHO, cap * sizeof(uint32_t));
+        if (!pilha) {
+            fprintf(stderr, "Erro ao alocar resumo das salas.\n");
+            exit(EXIT_FAILURE);
+        }
+        pilha[topo++] = 0;
+        while (topo > 0) {
+            uint32_t it = pilha[--topo], i = it & 0x7FFFFFFFu;
+            if (it & 0x80000000u) { juntarResumo(c, r, i); continue; }
+            if (topo + 3 > cap) {
+                cap *= 2;
+                uint32_t *nova = (uint32_t *)memRealocar(MEM_TRABALHO, pilha, cap * sizeof(uint32_t));
+                if (!nova) {
+                    fprintf(stderr, "Erro ao alocar resumo das salas.\n");
+                    exit(EXIT_FAILURE);
+                }
+                pilha = nova;
+            }
+            pilha[topo++] = i | 0x80000000u;
+            if (casoDir(c, i) != CASO_NENHUM) pilha[topo++] = casoDir(c, i);
+            if (casoEsq(c, i) != CASO_NENHUM) pilha[topo++] = casoEsq(c, i);
+        }
+        memLiberar(pilha);
+    }
+}
+
+void liberarResumo(ResumoSuspeitos *r) {
+    memLiberar(r->bits);
+    r->bits = NULL;
+    r->palavras = 0;
+}
+
+/* Dica ao lado de um caminho: suspeitos com pista daquela sala em diante.
+   Faz parte da linha do caminho: some junto com ela em --silencioso. */
+static void imprimirDica(const CasoBinario *c, const ResumoSuspeitos *dicas, uint32_t sala) {
+    if (!dicas || silencioso) return;
+    const uint64_t *b = resumoDaSala(dicas, sala);
+    int algum = 0;
+    for (uint32_t w = 0; w < dicas->palavras; ++w) {
+        uint64_t x = b[w];
+        for (uint32_t j = 0; x; ++j, x >>= 1) {
+            if (!(x & 1)) continue;
+            printf("%s%s", algum ? ", " : "  [pistas adiante: ", casoTexto(c, c->suspeitos[w * 64 + j]));
+            algum = 1;
+        }
+    }
+    printf(algum ? "]" : "  [nenhuma pista adiante]");
+}
+
+/* explorarCaso() – mesma exploração, direto sobre o caso binário mapeado.
+   A pista e o suspeito vêm das tabelas do arquivo, sem strcmp por sala;
+   os ids são os próprios índices do caso (c->ordemPistas ordena a BST).
+   Com dicas != NULL, cada caminho mostra os suspeitos com pista adiante;
+   com viagem != NULL, 'i' leva a qualquer sala já visitada. */
+void explorarCaso(Arena *sessao, const CasoBinario *c, Evidencias *ev, const ResumoSuspeitos *dicas,
+                  const Viagem *viagem) {
+    uint32_t atual = 0; /* sala 0 = Hall */
+    uint8_t *visitadas = criarVisitadas(sessao, viagem, c);
+    textoMenu("\n==============================================\n");
+    textoMenu("    Detective Quest - Exploracao Final        \n");
+    textoMenu("==============================================\n");
+
+    while (1) {
+        printf("\nVoce esta em: %s\n", casoNomeSala(c, atual));
+        marcarVisitada(visitadas, atual);
+
+        uint32_t idx = casoPistaIdx(c, atual);
+        if (idx != CASO_NENHUM) {
+            const char *p = casoPistaSala(c, atual);
+            const char *sus = casoSuspeitoPista(c, idx);
+            registrarPista(sessao, ev, idx, c->ordemPistas[idx], p, casoSuspeitoIdx(c, idx));
+            if (sus) {
+                printf("Pista encontrada: \"%s\" -> suspeito associado: %s\n", p, sus);
+            } else {
+                printf("Pista encontrada: \"%s\" (sem suspeito associado)\n", p);
+            }
+        } else {
+            printf("Nenhuma pista encontrada aqui.\n");
+        }
+
+        uint32_t esq = casoEsq(c, atual), dir = casoDir(c, atual);
+        textoMenu("\nCaminhos disponiveis a partir de \"%s\":\n", casoNomeSala(c, atual));
+        if (esq != CASO_NENHUM) {
+            textoMenu("  (e) Esquerda: %s", casoNomeSala(c, esq));
+            imprimirDica(c, dicas, esq);
+            textoMenu("\n");
+        }
+        if (dir != CASO_NENHUM) {
+            textoMenu("  (d) Direita : %s", casoNomeSala(c, dir));
+            imprimirDica(c, dicas, dir);
+            textoMenu("\n");
+        }
+        if (viagem) textoMenu("  (i) Ir para uma sala ja visitada\n");
+        textoMenu("  (s) Sair da exploracao\n");
+        textoMenu(viagem ? "Escolha [e/d/i/s]: " : "Escolha [e/d/s]: ");
+
+        char op = lerOpcao();
+        if (op == 's') {
+            printf("\nExploracao encerrada pelo jogador.\n");
+            break;
+        } else if (op == 'e') {
+            if (esq == CASO_NENHUM) { printf("Nao ha caminho a esquerda.\n"); continue; }
+            atual = esq;
+        } else if (op == 'd') {
+            if (dir == CASO_NENHUM) { printf("Nao ha caminho a direita.\n"); continue; }
+            atual = dir;
+        } else if (op == 'i' && viagem) {
+            uint32_t destino = pedirViagem(c, viagem, visitadas, atual);
+            if (destino != CASO_NENHUM) atual = destino;
+        } else {
+            printf("Opcao invalida. Use 'e', 'd' ou 's'.\n");
+        }
+    }
+    descartarComandos();
+}
+
+/* ========================== Julgamento ========================== */
 
-static void contarSeDoAcusado(const PistaNode *n, void *ud) {
-    ContadorSuspeitoCtx *ctx = (ContadorSuspeitoCtx *)ud;
-    const char *sus = encontrarSuspeito((HashTable *)ctx->ht, n->texto);
-    if (sus && strcmp(sus, ctx->acusado) == 0) {
-        ctx->total += n->count;
+/* idDoSuspeito() – converte o nome digitado em id, uma vez por julgamento:
+   índice do suspeito no caso carregado, ou id na tabela de internação. */
+static uint32_t idDoSuspeito(const CasoBinario *caso, const char *nome) {
+    if (caso && caso->salas) {
+        for (uint32_t i = 0; i < caso->numSuspeitos; ++i) {
+            if (strcmp(casoTexto(caso, caso->suspeitos[i]), nome) == 0) return i;
+        }
+        return ID_NENHUM;
     }
+    return buscarInterno(nome);
 }
 
-/* verificarSuspeitoFinal() – conduz à fase de julgamento final. */
-void verificarSuspeitoFinal(PistaNode *pistas, HashTable *ht) {
+/* julgarSuspeito() – quantas pistas coletadas apontam para o suspeito de
+   nome 'nome': o cálculo do veredito, sem a conversa com o jogador. */
+int julgarSuspeito(const Evidencias *ev, const CasoBinario *caso, const char *nome) {
+    return pistasContra(ev, idDoSuspeito(caso, nome));
+}
+
+/* verificarSuspeitoFinal() – conduz à fase de julgamento final.
+   caso: o caso carregado, ou NULL/vazio para a mansão embutida.
+   A contagem vem dos contadores da exploração: a BST só é listada. */
+void verificarSuspeitoFinal(const Evidencias *ev, const CasoBinario *caso) {
     printf("\n=========== Pistas coletadas (ordem alfabetica) ===========\n");
-    if (pistas) exibirPistas(pistas);
+    if (ev->pistas) exibirPistas(ev->pistas);
     else        printf("(Nenhuma pista coletada)\n");
     printf("===========================================================\n");
 
     /* Entrada do acusado */
     char entrada[128];
-    printf("Informe o nome do suspeito para acusacao (ex.: \"Srta. Violeta\"): ");
-    if (!fgets(entrada, sizeof(entrada), stdin)) {
+    textoMenu("Informe o nome do suspeito para acusacao (ex.: \"Srta. Violeta\"): ");
+    fflush(stdout);
+    if (!estLerLinha(entrada, sizeof(entrada), stdin)) {
         printf("Entrada invalida. Encerrando julgamento.\n");
         return;
     }
@@ -352,118 +899,1727 @@ void verificarSuspeitoFinal(PistaNode *pistas, HashTable *ht) {
         return;
     }
 
-    /* Conta quantas pistas coletadas apontam para o acusado */
-    ContadorSuspeitoCtx ctx = { ht, entrada, 0 };
-    percorrerInOrder(pistas, contarSeDoAcusado, &ctx);
+    int total = julgarSuspeito(ev, caso, entrada);
 
-    if (ctx.total >= 2) {
+    if (total >= 2) {
         printf("\nVEREDITO: CULPADO!\n");
-        printf("Ha pelo menos %d pista(s) que apontam para %s. Caso encerrado.\n", ctx.total, entrada);
+        printf("Ha pelo menos %d pista(s) que apontam para %s. Caso encerrado.\n", total, entrada);
     } else {
         printf("\nVEREDITO: INSUFICIENTE.\n");
-        printf("Apenas %d pista(s) apontam para %s. Investigacao inconclusiva.\n", ctx.total, entrada);
+        printf("Apenas %d pista(s) apontam para %s. Investigacao inconclusiva.\n", total, entrada);
     }
 }
 
-/* ======================== Montagem do Mapa ======================== */
-/*
-   Layout fixo (mesmo do capítulo anterior):
+/* ==================== Roteiros (modo não interativo) ==================== */
+/* --replay arquivo ("-" = entrada padrão): cada linha é uma sessão,
+       movimentos acusado            ex.: "ddds Jardineiro"
+   Movimentos são letras e/d/s, como no menu: a sessão termina no primeiro
+   's' ou no fim das letras; caminho inexistente ou letra inválida revisita
+   a sala atual, exatamente como na exploração interativa. Linhas vazias
+   ou iniciadas por '#' são ignoradas.
 
-                 [Hall de Entrada]
-                   /           \
-         [Sala de Estar]     [Corredor]
-            /      \           /     \
-     [Biblioteca] [Cozinha] [Escritorio] [Jardim]
-        /     \         \                    \
-    [Adega] [Deposito] [Despensa]          [Estufa]
-*/
-Sala *montarMapa() {
-    Sala *hall        = criarSala("Hall de Entrada");
-    Sala *estar       = criarSala("Sala de Estar");
-    Sala *corredor    = criarSala("Corredor");
-    Sala *biblio      = criarSala("Biblioteca");
-    Sala *cozinha     = criarSala("Cozinha");
-    Sala *escritorio  = criarSala("Escritorio");
-    Sala *jardim      = criarSala("Jardim");
-    Sala *adega       = criarSala("Adega");
-    Sala *deposito    = criarSala("Deposito");
-    Sala *despensa    = criarSala("Despensa");
-    Sala *estufa      = criarSala("Estufa");
+   Nada de menus: cada sessão gera um registro
+       numero;CULPADO|INSUFICIENTE;pistas contra o acusado;coletas;sala final
+   e, ao fim, a vazão vai para stderr. Uma sessão não aloca nada: conta só
+   as pistas do acusado (resolvido para id antes de andar). */
 
-    hall->esq = estar;      hall->dir = corredor;
-    estar->esq = biblio;    estar->dir = cozinha;
-    corredor->esq = escritorio; corredor->dir = jardim;
-    biblio->esq = adega;    biblio->dir = deposito;
-    cozinha->dir = despensa;
-    jardim->dir = estufa;
+/* Anda pelo mapa embutido; devolve a sala final. */
+static const Sala *roteiroSalas(const Sala *atual, const HashTable *ht, const char *mov,
+                                uint32_t acusado, int *contra, int *coletas) {
+    for (;; ++mov) {
+        if (atual->pista != ID_NENHUM) {
+            ++*coletas;
+            if (encontrarSuspeitoId(ht, atual->pista) == acusado) ++*contra;
+        }
+        char op = (char)tolower((unsigned char)*mov);
+        if (op == '\0' || op == 's') return atual;
+        if (op == 'e' && atual->esq)      atual = atual->esq;
+        else if (op == 'd' && atual->dir) atual = atual->dir;
+    }
+}
 
-    return hall; /* raiz */
+/* Mesmo roteiro sobre o caso carregado; devolve o índice da sala final. */
+static uint32_t roteiroCaso(const CasoBinario *c, const char *mov,
+                            uint32_t acusado, int *contra, int *coletas) {
+    uint32_t atual = 0; /* sala 0 = Hall */
+    for (;; ++mov) {
+        uint32_t idx = casoPistaIdx(c, atual);
+        if (idx != CASO_NENHUM) {
+            ++*coletas;
+            if (casoSuspeitoIdx(c, idx) == acusado) ++*contra;
+        }
+        char op = (char)tolower((unsigned char)*mov);
+        if (op == '\0' || op == 's') return atual;
+        uint32_t prox = (op == 'e') ? casoEsq(c, atual) : (op == 'd') ? casoDir(c, atual) : CASO_NENHUM;
+        if (prox != CASO_NENHUM) atual = prox;
+    }
 }
 
-/* ======================= Povoamento da Hash ======================= */
-/* Popula a tabela hash com associações pista -> suspeito.
-   Ajuste os nomes para o enredo desejado. */
-void popularMapaPistas(HashTable *ht) {
-    /* Suspeitos de exemplo */
-    /* - Sr. Mostarda
-       - Srta. Violeta
-       - Coronel Mostarda (se preferir variação)
-       - Dra. Orquidea
-       - Professor Carvalho
-       - Sra. Branca
-       - Jardineiro */
+static double agoraSegundos(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
 
-    inserirNaHash(ht, "Pegadas de lama",        "Jardineiro");
-    inserirNaHash(ht, "Almofada fora do lugar", "Sra. Branca");
-    inserirNaHash(ht, "Perfume forte",          "Srta. Violeta");
-    inserirNaHash(ht, "Livro raro deslocado",   "Professor Carvalho");
-    inserirNaHash(ht, "Janela entreaberta",     "Sr. Mostarda");
-    inserirNaHash(ht, "Luva de couro",          "Sr. Mostarda");
-    inserirNaHash(ht, "Taca com batom",         "Srta. Violeta");
-    inserirNaHash(ht, "Rastro de acucar",       "Dra. Orquidea");
-    inserirNaHash(ht, "Terra revolvida",        "Jardineiro");
+/* O que as sessões compartilham: mapa, tabela pista -> suspeito e caso.
+   Nada disso muda depois da carga, então várias threads leem sem trava. */
+typedef struct Tabuleiro {
+    const CasoBinario *caso;     /* caso carregado (salas != NULL) ou vazio */
+    const Sala *mapa;            /* mansão embutida, se não houver caso */
+    const HashTable *ht;
+} Tabuleiro;
 
-    /* Alias com acentos removidos nos textos das pistas para simplificar
-       comparação em ambientes sem locale configurado. */
+#define FORMATO_REGISTRO "%lu;%s;%d;%d;%s\n"
+
+/* Linha de roteiro com sessão? (não vazia nem comentário) */
+static int linhaDeSessao(const char *linha) {
+    while (isspace((unsigned char)*linha)) ++linha;
+    return *linha != '\0' && *linha != '#';
 }
 
-/* =============================== main ============================== */
-int main(void) {
-    /* 1) Monta o mapa fixo */
-    Sala *mapa = montarMapa();
+/* sessaoRoteiro() – joga uma linha de roteiro (alterada no lugar: o
+   acusado é separado dos movimentos) e devolve o nome da sala final. */
+static const char *sessaoRoteiro(const Tabuleiro *t, char *linha, int *contra, int *coletas) {
+    rstrip(linha);
+    char *mov = linha;
+    while (isspace((unsigned char)*mov)) ++mov;
+    char *acusado = mov;
+    while (*acusado && !isspace((unsigned char)*acusado)) ++acusado;
+    if (*acusado) *acusado++ = '\0';
+    while (isspace((unsigned char)*acusado)) ++acusado;
 
-    /* 2) Cria a tabela hash e popula com pista -> suspeito */
-    HashTable *ht = criarHash(101);
-    popularMapaPistas(ht);
+    uint32_t idAcusado = (*acusado) ? idDoSuspeito(t->caso, acusado) : ID_NENHUM;
+    const char *salaFinal;
+    *contra = *coletas = 0;
+    if (t->caso && t->caso->salas) {
+        salaFinal = casoNomeSala(t->caso, roteiroCaso(t->caso, mov, idAcusado, contra, coletas));
+    } else {
+        salaFinal = roteiroSalas(t->mapa, t->ht, mov, idAcusado, contra, coletas)->nome;
+    }
+    if (idAcusado == ID_NENHUM) *contra = 0; /* sem acusado (ou desconhecido): nada conta */
+    return salaFinal;
+}
 
-    /* 3) Loop simples de menu */
-    while (1) {
-        printf("\n===== Menu =====\n");
-        printf("1 - Explorar mansao e coletar pistas\n");
-        printf("0 - Sair\n");
-        printf("Opcao: ");
+/* executarRoteiros() – roda todas as sessões de 'in' e escreve os
+   registros em 'out'. Devolve quantas sessões foram executadas. */
+unsigned long executarRoteiros(FILE *in, FILE *out, const Tabuleiro *t) {
+    char *linha = NULL;
+    size_t cap = 0;
+    unsigned long numero = 0;
+    double t0 = agoraSegundos();
 
-        char linha[32];
-        if (!fgets(linha, sizeof(linha), stdin)) break;
-        int opcao = atoi(linha);
+    while (lerLinhaLonga(in, &linha, &cap)) {
+        if (!linhaDeSessao(linha)) continue;
 
-        if (opcao == 1) {
-            /* BST de pistas inicia vazia a cada exploração */
-            PistaNode *pistas = NULL;
+        int contra, coletas;
+        const char *salaFinal = sessaoRoteiro(t, linha, &contra, &coletas);
+        fprintf(out, FORMATO_REGISTRO, ++numero,
+                contra >= 2 ? "CULPADO" : "INSUFICIENTE", contra, coletas, salaFinal);
+    }
+    memLiberar(linha);
 
-            explorarSalas(mapa, &pistas, ht);
-            verificarSuspeitoFinal(pistas, ht);
+    double tempo = agoraSegundos() - t0;
+    fprintf(stderr, "%lu sessoes em %.3f s (%.0f sessoes/s)\n",
+            numero, tempo, tempo > 0 ? (double)numero / tempo : 0.0);
+    return numero;
+}
 
-            liberarBST(pistas);
-        } else if (opcao == 0) {
-            break;
-        } else {
-            printf("Opcao invalida.\n");
+/* ===================== Motor paralelo (--threads N) ===================== */
+/* Com --threads N (N > 1), os roteiros são lidos inteiros para a memória e
+   divididos em blocos de SESSOES_POR_BLOCO sessões. Cada thread recebe uma
+   faixa contígua de blocos e pega o próximo com um fetch_add no cursor da
+   própria faixa; quando ela se esgota, rouba das faixas das outras threads
+   com o mesmo fetch_add. Não há trava em lugar nenhum: o tabuleiro é só
+   leitura, cada sessão conta na própria pilha e cada thread formata os
+   registros dos seus blocos na sua arena. As sessões saem do mesmo leitor
+   de linhas do modo sequencial (lerLinhaLonga + linhaDeSessao) e, no fim,
+   os blocos são escritos em ordem, então a saída é idêntica à dele. */
+#define MAX_THREADS 256
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define SESSOES_POR_BLOCO 4096
+
+/* Uma faixa por thread, cada uma na sua linha de cache. */
+typedef struct FaixaBlocos {
+    _Alignas(64) atomic_size_t proximo;  /* próximo bloco a ser pego */
+    size_t fim;                           /* um após o último bloco da faixa */
+} FaixaBlocos;
+
+typedef struct MotorRoteiros {
+    const Tabuleiro *tabuleiro;
+    char **linhas;               /* uma linha de sessão por posição */
+    size_t numSessoes;
+    size_t numBlocos;
+    const char **textoBloco;     /* registros formatados de cada bloco */
+    size_t *tamBloco;
+    FaixaBlocos *faixas;         /* uma por thread */
+    int numThreads;
+} MotorRoteiros;
+
+typedef struct Trabalhador {
+    MotorRoteiros *motor;
+    int indice;
+    Arena arena;                 /* registros dos blocos desta thread */
+    size_t roubados;             /* blocos pegos das faixas de outras threads */
+} Trabalhador;
+
+/* Joga as sessões do bloco b e guarda os registros na arena da thread. */
+static void executarBloco(Trabalhador *w, size_t b, char **buf, size_t *cap) {
+    MotorRoteiros *m = w->motor;
+    size_t ini = b * SESSOES_POR_BLOCO;
+    size_t fim = ini + SESSOES_POR_BLOCO < m->numSessoes ? ini + SESSOES_POR_BLOCO : m->numSessoes;
+    size_t usado = 0;
+
+    for (size_t i = ini; i < fim; ++i) {
+        int contra, coletas;
+        const char *salaFinal = sessaoRoteiro(m->tabuleiro, m->linhas[i], &contra, &coletas);
+        size_t precisa = strlen(salaFinal) + 64; /* número, veredito e contagens cabem em 64 */
+        if (usado + precisa > *cap) {
+            size_t novaCap = *cap ? *cap * 2 : 256 * 1024;
+            while (usado + precisa > novaCap) novaCap *= 2;
+            char *novo = (char *)memRealocar(MEM_TEXTOS, *buf, novaCap);
+            if (!novo) {
+                fprintf(stderr, "Erro ao alocar registros.\n");
+                exit(EXIT_FAILURE);
+            }
+            *buf = novo;
+            *cap = novaCap;
         }
+        usado += (size_t)sprintf(*buf + usado, FORMATO_REGISTRO, (unsigned long)(i + 1),
+                                 contra >= 2 ? "CULPADO" : "INSUFICIENTE", contra, coletas, salaFinal);
     }
 
-    liberarHash(ht);
-    liberarArvoreSalas(mapa);
-    printf("Programa encerrado. Ate a proxima!\n");
-    return 0;
-}
\ No newline at end of file
+    char *texto = (char *)arenaAlocar(&w->arena, usado ? usado : 1, MEM_TEXTOS);
+    memcpy(texto, *buf, usado);
+    m->textoBloco[b] = texto;
+    m->tamBloco[b] = usado;
+}
+
+static void *trabalhar(void *arg) {
+    Trabalhador *w = (Trabalhador *)arg;
+    MotorRoteiros *m = w->motor;
+    char *buf = NULL;
+    size_t cap = 0;
+
+    /* k = 0: a própria faixa; depois, as das vizinhas, em ordem circular */
+    for (int k = 0; k < m->numThreads; ++k) {
+        FaixaBlocos *f = &m->faixas[(w->indice + k) % m->numThreads];
+        for (;;) {
+            size_t b = atomic_fetch_add_explicit(&f->proximo, 1, memory_order_relaxed);
+            if (b >= f->fim) break;
+            executarBloco(w, b, &buf, &cap);
+            if (k) w->roubados++;
+        }
+    }
+    memLiberar(buf);
+    EST_ENTREGAR_THREAD();
+    return NULL;
+}
+
+/* Lê toda a entrada, linha a linha com o mesmo lerLinhaLonga() e o mesmo
+   filtro linhaDeSessao() do modo sequencial, e guarda as sessões uma após
+   a outra em *conteudo. */
+static char **lerRoteiros(FILE *in, char **conteudo, size_t *numSessoes) {
+    size_t cap = 1 << 20, tam = 0;
+    size_t capLinhas = 1024, n = 0;
+    char *buf = (char *)memAlocar(MEM_TEXTOS, cap);
+    size_t *inicio = (size_t *)memAlocar(MEM_TRABALHO, capLinhas * sizeof(size_t));
+    char *linha = NULL;
+    size_t capLinha = 0;
+    while (buf && inicio && lerLinhaLonga(in, &linha, &capLinha)) {
+        if (!linhaDeSessao(linha)) continue;
+        size_t len = strlen(linha) + 1;
+        if (tam + len > cap) {
+            while (tam + len > cap) cap *= 2;
+            char *novo = (char *)memRealocar(MEM_TEXTOS, buf, cap);
+            if (!novo) { memLiberar(buf); buf = NULL; break; }
+            buf = novo;
+        }
+        if (n == capLinhas) {
+            size_t *novo = (size_t *)memRealocar(MEM_TRABALHO, inicio, capLinhas * 2 * sizeof(size_t));
+            if (!novo) { memLiberar(inicio); inicio = NULL; break; }
+            inicio = novo;
+            capLinhas *= 2;
+        }
+        memcpy(buf + tam, linha, len);
+        inicio[n++] = tam;
+        tam += len;
+    }
+    memLiberar(linha);
+
+    /* só agora os ponteiros: o buffer pode ter mudado de lugar */
+    char **linhas = (buf && inicio) ? (char **)memAlocar(MEM_TRABALHO, (n ? n : 1) * sizeof(char *)) : NULL;
+    if (!linhas) {
+        fprintf(stderr, "Erro ao ler roteiros.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < n; ++i) linhas[i] = buf + inicio[i];
+    memLiberar(inicio);
+    *conteudo = buf;
+    *numSessoes = n;
+    return linhas;
+}
+
+/* executarRoteirosParalelo() – mesma saída de executarRoteiros(), com
+   numThreads threads sobre o mesmo tabuleiro. */
+unsigned long executarRoteirosParalelo(FILE *in, FILE *out, const Tabuleiro *t, int numThreads) {
+    double t0 = agoraSegundos();
+    MotorRoteiros m;
+    char *conteudo;
+    m.tabuleiro = t;
+    m.linhas = lerRoteiros(in, &conteudo, &m.numSessoes);
+    m.numBlocos = (m.numSessoes + SESSOES_POR_BLOCO - 1) / SESSOES_POR_BLOCO;
+    m.numThreads = numThreads;
+    m.textoBloco = (const char **)memAlocar(MEM_TRABALHO, (m.numBlocos + 1) * sizeof(char *));
+    m.tamBloco = (size_t *)memAlocar(MEM_TRABALHO, (m.numBlocos + 1) * sizeof(size_t));
+    m.faixas = (FaixaBlocos *)memAlinhada(MEM_TRABALHO, 64, (size_t)numThreads * sizeof(FaixaBlocos));
+    Trabalhador *ws = (Trabalhador *)memZerada(MEM_TRABALHO, (size_t)numThreads, sizeof(Trabalhador));
+    pthread_t *ids = (pthread_t *)memAlocar(MEM_TRABALHO, (size_t)numThreads * sizeof(pthread_t));
+    if (!m.textoBloco || !m.tamBloco || !m.faixas || !ws || !ids) {
+        fprintf(stderr, "Erro ao alocar motor de roteiros.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* faixas contíguas e do mesmo tamanho (±1 bloco) */
+    for (int i = 0; i < numThreads; ++i) {
+        atomic_init(&m.faixas[i].proximo, m.numBlocos * (size_t)i / (size_t)numThreads);
+        m.faixas[i].fim = m.numBlocos * (size_t)(i + 1) / (size_t)numThreads;
+    }
+    double t1 = agoraSegundos();
+
+    int criadas = 0;
+    for (int i = 0; i < numThreads; ++i) {
+        ws[i].motor = &m;
+        ws[i].indice = i;
+        if (pthread_create(&ids[i], NULL, trabalhar, &ws[i]) != 0) break;
+        criadas++;
+    }
+    if (criadas == 0) trabalhar(&ws[0]); /* sem threads: a própria main faz tudo */
+    for (int i = 0; i < criadas; ++i) pthread_join(ids[i], NULL);
+    double t2 = agoraSegundos();
+
+    size_t roubados = 0;
+    for (size_t b = 0; b < m.numBlocos; ++b) fwrite(m.textoBloco[b], 1, m.tamBloco[b], out);
+    for (int i = 0; i < numThreads; ++i) {
+        roubados += ws[i].roubados;
+        arenaLiberar(&ws[i].arena);
+    }
+    double t3 = agoraSegundos();
+
+    double tempo = t2 - t1;
+    fprintf(stderr, "%zu sessoes em %.3f s (%.0f sessoes/s, %d threads, %zu blocos roubados;"
+                    " leitura %.3f s, escrita %.3f s)\n",
+            m.numSessoes, tempo, tempo > 0 ? (double)m.numSessoes / tempo : 0.0,
+            criadas ? criadas : 1, roubados, t1 - t0, t3 - t2);
+
+    memLiberar(ids);
+    memLiberar(ws);
+    memLiberar(m.faixas);
+    memLiberar(m.tamBloco);
+    memLiberar((void *)m.textoBloco);
+    memLiberar(m.linhas);
+    memLiberar(conteudo);
+    return (unsigned long)m.numSessoes;
+}
+#endif /* !_WIN32 */
+
+/* ======================= Resolvedor (--resolver) ======================= */
+/* O jogador só desce, então toda partida é um caminho a partir do Hall e,
+   como as contagens só crescem ao longo do caminho, o melhor resultado de
+   cada suspeito é o máximo, sobre todas as salas, da contagem acumulada
+   da raiz até ela, cada sala contada uma vez.
+
+   O jogo, porém, conta cada coleta: uma opção inválida (ou caminho
+   inexistente) revisita a sala atual e coleta a pista de novo, no menu e
+   no --replay. Então uma única pista alcançável já condena: basta parar
+   na sala dela e insistir. O relatório separa os dois casos – CONDENAVEL
+   com >= 2 pistas distintas no caminho, "CONDENAVEL revisitando" com 1,
+   e o caminho deste último termina com 'x' (a revisita); só quem não tem
+   pista alcançável é insuficiente.
+
+   Uma busca em profundidade iterativa mantém a contagem do caminho atual
+   por suspeito e um registro de desfazer; cada sala custa O(1), sem
+   recursão (mansões degeneradas têm milhões de níveis). Para usar várias
+   threads, os primeiros níveis são abertos até haver subárvores bastantes
+   (a "fronteira"); cada subárvore é resolvida a partir de contagem zero e
+   o resultado é somado à contagem do caminho até ela. As subárvores são
+   distribuídas com um fetch_add; a mansão é só leitura.
+
+   A mesma busca serve à árvore de ponteiros e à forma compacta (caso
+   carregado ou --compacto): a sala é um NoSala e os acessores escolhem a
+   representação. Na forma compacta em pré-ordem a busca lê o vetor de
+   salas em sequência, 16 bytes por sala. */
+
+#define NIVEIS_MAX_FRONTEIRA 40
+#define SUBARVORES_POR_THREAD 8
+
+/* Suspeitos em índices compactos 0..numSuspeitos-1 (os ids internados são
+   esparsos: também numeram salas e pistas). */
+typedef struct Resolvedor {
+    const HashTable *ht;
+    const CasoBinario *caso;     /* não-NULL: forma compacta (suspeitos já compactos) */
+    uint32_t *compacto;          /* id internado -> índice compacto (ID_NENHUM) */
+    uint32_t *idSuspeito;        /* índice compacto -> id internado */
+    uint32_t numIds, numSuspeitos;
+} Resolvedor;
+
+/* Sala no resolvedor: ponteiro para Sala ou, na forma compacta, índice + 1.
+   0 é "nenhuma" nas duas. */
+typedef uintptr_t NoSala;
+
+static NoSala noDoIndice(uint32_t i) { return (i == CASO_NENHUM) ? 0 : (NoSala)i + 1; }
+
+static NoSala filhoEsq(const Resolvedor *r, NoSala n) {
+    if (r->caso) return noDoIndice(casoEsq(r->caso, (uint32_t)(n - 1)));
+    return (NoSala)((const Sala *)n)->esq;
+}
+
+static NoSala filhoDir(const Resolvedor *r, NoSala n) {
+    if (r->caso) return noDoIndice(casoDir(r->caso, (uint32_t)(n - 1)));
+    return (NoSala)((const Sala *)n)->dir;
+}
+
+static const char *nomeDoNo(const Resolvedor *r, NoSala n) {
+    return r->caso ? casoNomeSala(r->caso, (uint32_t)(n - 1)) : ((const Sala *)n)->nome;
+}
+
+static uint32_t suspeitoDaSala(const Resolvedor *r, NoSala n) {
+    if (r->caso) {
+        uint32_t p = casoPistaIdx(r->caso, (uint32_t)(n - 1));
+        return (p == CASO_NENHUM) ? ID_NENHUM : casoSuspeitoIdx(r->caso, p);
+    }
+    uint32_t id = encontrarSuspeitoId(r->ht, ((const Sala *)n)->pista);
+    return (id < r->numIds) ? r->compacto[id] : ID_NENHUM;
+}
+
+/* Subárvore da fronteira: caminho até ela e contagens dos ancestrais. */
+typedef struct Subarvore {
+    NoSala raiz;
+    char caminho[NIVEIS_MAX_FRONTEIRA + 1];
+} Subarvore;
+
+typedef struct ItemBusca {
+    NoSala sala;
+    size_t marca;                /* tamanho do registro de desfazer / profundidade */
+    char mov;                    /* 'e' ou 'd' (0 na raiz) */
+} ItemBusca;
+
+/* Pilha e contagens de uma thread, reaproveitadas entre subárvores. */
+typedef struct Rascunho {
+    ItemBusca *pilha;
+    size_t capPilha;
+    uint32_t *desfazer;
+    size_t numDesfazer, capDesfazer;
+    int *contagem;
+} Rascunho;
+
+static void *crescerVetor(void *v, size_t *cap, size_t tamItem) {
+    size_t nova = *cap ? *cap * 2 : 1024;
+    void *p = memRealocar(MEM_TRABALHO, v, nova * tamItem);
+    if (!p) {
+        fprintf(stderr, "Erro ao alocar pilha do resolvedor.\n");
+        exit(EXIT_FAILURE);
+    }
+    *cap = nova;
+    return p;
+}
+
+/* Melhor contagem por suspeito dentro da subárvore (a partir de zero) e a
+   sala onde ela é atingida pela primeira vez (ordem esquerda-primeiro). */
+static void resolverSubarvore(const Resolvedor *r, NoSala raiz, Rascunho *rs,
+                              int *melhor, NoSala *fim) {
+    for (uint32_t k = 0; k < r->numSuspeitos; ++k) {
+        rs->contagem[k] = 0;
+        melhor[k] = 0;
+        fim[k] = raiz;
+    }
+    rs->numDesfazer = 0;
+    size_t topo = 0;
+    if (rs->capPilha == 0) rs->pilha = (ItemBusca *)crescerVetor(rs->pilha, &rs->capPilha, sizeof(ItemBusca));
+    rs->pilha[topo++] = (ItemBusca){ raiz, 0, 0 };
+
+    /* desce pela esquerda sem empilhar; só o filho da direita espera */
+    while (topo > 0) {
+        ItemBusca it = rs->pilha[--topo];
+        while (rs->numDesfazer > it.marca) rs->contagem[rs->desfazer[--rs->numDesfazer]]--;
+
+        for (NoSala n = it.sala; n; n = filhoEsq(r, n)) {
+            uint32_t k = suspeitoDaSala(r, n);
+            if (k != ID_NENHUM) {
+                if (rs->numDesfazer == rs->capDesfazer) {
+                    rs->desfazer = (uint32_t *)crescerVetor(rs->desfazer, &rs->capDesfazer, sizeof(uint32_t));
+                }
+                rs->desfazer[rs->numDesfazer++] = k;
+                if (++rs->contagem[k] > melhor[k]) {
+                    melhor[k] = rs->contagem[k];
+                    fim[k] = n;
+                }
+            }
+            NoSala dir = filhoDir(r, n);
+            if (dir) {
+                if (topo == rs->capPilha) rs->pilha = (ItemBusca *)crescerVetor(rs->pilha, &rs->capPilha, sizeof(ItemBusca));
+                rs->pilha[topo++] = (ItemBusca){ dir, rs->numDesfazer, 'd' };
+            }
+        }
+    }
+}
+
+typedef struct TrabalhoResolver {
+    const Resolvedor *r;
+    const Subarvore *subs;
+    size_t numSubs;
+    int *melhor;                 /* numSubs x numSuspeitos */
+    NoSala *fim;                 /* numSubs x numSuspeitos */
+#ifndef _WIN32
+    atomic_size_t proxima;
+#else
+    size_t proxima;
+#endif
+} TrabalhoResolver;
+
+static void *trabalharResolver(void *arg) {
+    TrabalhoResolver *t = (TrabalhoResolver *)arg;
+    Rascunho rs;
+    memset(&rs, 0, sizeof(rs));
+    rs.contagem = (int *)memAlocar(MEM_TRABALHO, (t->r->numSuspeitos + 1) * sizeof(int));
+    if (!rs.contagem) {
+        fprintf(stderr, "Erro ao alocar contagens do resolvedor.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (;;) {
+#ifndef _WIN32
+        size_t i = atomic_fetch_add_explicit(&t->proxima, 1, memory_order_relaxed);
+#else
+        size_t i = t->proxima++;
+#endif
+        if (i >= t->numSubs) break;
+        size_t base = i * t->r->numSuspeitos;
+        resolverSubarvore(t->r, t->subs[i].raiz, &rs, t->melhor + base, t->fim + base);
+    }
+    memLiberar(rs.pilha);
+    memLiberar(rs.desfazer);
+    memLiberar(rs.contagem);
+    EST_ENTREGAR_THREAD();
+    return NULL;
+}
+
+/* Abre os primeiros níveis até ter 'alvo' subárvores (ou esgotar os níveis),
+   da esquerda para a direita (a ordem da busca sequencial). Por subárvore e
+   suspeito, a fronteira guarda a contagem nos ancestrais e o último deles
+   que a incrementou (a sala final quando a subárvore não acrescenta nada). */
+typedef struct Fronteira {
+    Subarvore *subs;
+    size_t num;
+    int *prefixo;                /* num x K */
+    NoSala *ultimo;              /* num x K: último ancestral que contou */
+    unsigned char *profUltimo;   /* num x K: profundidade dele */
+} Fronteira;
+
+static void abrirFronteira(const Resolvedor *r, NoSala raiz, size_t alvo, Fronteira *fr) {
+    uint32_t K = r->numSuspeitos;
+    fr->num = 1;
+    fr->subs = (Subarvore *)memZerada(MEM_TRABALHO, 1, sizeof(Subarvore));
+    fr->prefixo = (int *)memZerada(MEM_TRABALHO, K + 1, sizeof(int));
+    fr->ultimo = (NoSala *)memAlocar(MEM_TRABALHO, (K + 1) * sizeof(NoSala));
+    fr->profUltimo = (unsigned char *)memZerada(MEM_TRABALHO, K + 1, 1);
+    if (!fr->subs || !fr->prefixo || !fr->ultimo || !fr->profUltimo) {
+        fprintf(stderr, "Erro ao alocar fronteira do resolvedor.\n");
+        exit(EXIT_FAILURE);
+    }
+    fr->subs[0].raiz = raiz;
+    for (uint32_t k = 0; k < K; ++k) fr->ultimo[k] = raiz;
+
+    for (int nivel = 0; nivel < NIVEIS_MAX_FRONTEIRA && fr->num < alvo; ++nivel) {
+        size_t cap = 2 * fr->num;
+        Fronteira nova;
+        nova.subs = (Subarvore *)memZerada(MEM_TRABALHO, cap, sizeof(Subarvore));
+        nova.prefixo = (int *)memAlocar(MEM_TRABALHO, (cap * K + 1) * sizeof(int));
+        nova.ultimo = (NoSala *)memAlocar(MEM_TRABALHO, (cap * K + 1) * sizeof(NoSala));
+        nova.profUltimo = (unsigned char *)memAlocar(MEM_TRABALHO, cap * K + 1);
+        if (!nova.subs || !nova.prefixo || !nova.ultimo || !nova.profUltimo) {
+            fprintf(stderr, "Erro ao alocar fronteira do resolvedor.\n");
+            exit(EXIT_FAILURE);
+        }
+        size_t m = 0;
+        int abriu = 0;
+        for (size_t i = 0; i < fr->num; ++i) {
+            NoSala s = fr->subs[i].raiz;
+            NoSala filhos[2] = { filhoEsq(r, s), filhoDir(r, s) };
+            int folha = !filhos[0] && !filhos[1];
+            uint32_t k = folha ? ID_NENHUM : suspeitoDaSala(r, s);
+            for (int f = 0; f < 2; ++f) {
+                if (!folha && !filhos[f]) continue;
+                memcpy(nova.prefixo + m * K, fr->prefixo + i * K, K * sizeof(int));
+                memcpy(nova.ultimo + m * K, fr->ultimo + i * K, K * sizeof(NoSala));
+                memcpy(nova.profUltimo + m * K, fr->profUltimo + i * K, K);
+                if (folha) { /* folha: continua como está */
+                    nova.subs[m++] = fr->subs[i];
+                    break;
+                }
+                nova.subs[m].raiz = filhos[f];
+                memcpy(nova.subs[m].caminho, fr->subs[i].caminho, (size_t)nivel);
+                nova.subs[m].caminho[nivel] = f ? 'd' : 'e';
+                if (k != ID_NENHUM) {
+                    nova.prefixo[m * K + k]++;
+                    nova.ultimo[m * K + k] = s;
+                    nova.profUltimo[m * K + k] = (unsigned char)nivel;
+                }
+                m++;
+            }
+            abriu |= !folha;
+        }
+        memLiberar(fr->subs); memLiberar(fr->prefixo); memLiberar((void *)fr->ultimo); memLiberar(fr->profUltimo);
+        nova.num = m;
+        *fr = nova;
+        if (!abriu) break;
+    }
+    /* folhas mantidas têm caminho mais curto que o nível: já terminam em '\0' (calloc) */
+}
+
+static int compararNos(const void *a, const void *b) {
+    NoSala x = *(const NoSala *)a, y = *(const NoSala *)b;
+    return (x > y) - (x < y);
+}
+
+/* Caminho (e/d) da raiz da subárvore até cada sala de 'alvos' (ordenado).
+   Um filtro de 64 bits descarta quase todas as salas antes do bsearch. */
+static unsigned bitDoFiltro(NoSala n) {
+    return (unsigned)(((uint64_t)n * 0x9E3779B97F4A7C15ull) >> 58);
+}
+
+static void caminhosAte(const Resolvedor *r, NoSala raiz, const NoSala *alvos, size_t numAlvos,
+                        char **caminhos, size_t *tamanhos) {
+    size_t capPilha = 0, capCaminho = 0, topo = 0, achados = 0;
+    ItemBusca *pilha = (ItemBusca *)crescerVetor(NULL, &capPilha, sizeof(ItemBusca));
+    char *caminho = (char *)crescerVetor(NULL, &capCaminho, 1);
+    pilha[topo++] = (ItemBusca){ raiz, 0, 0 };
+    uint64_t filtro = 0;
+    for (size_t i = 0; i < numAlvos; ++i) filtro |= 1ull << bitDoFiltro(alvos[i]);
+
+    while (topo > 0 && achados < numAlvos) {
+        ItemBusca it = pilha[--topo];
+        if (it.marca > 0) {
+            while (it.marca > capCaminho) caminho = (char *)crescerVetor(caminho, &capCaminho, 1);
+            caminho[it.marca - 1] = it.mov;
+        }
+        const NoSala *p = ((filtro >> bitDoFiltro(it.sala)) & 1)
+            ? (const NoSala *)bsearch(&it.sala, alvos, numAlvos, sizeof(*alvos), compararNos) : NULL;
+        if (p) {
+            size_t i = (size_t)(p - alvos);
+            caminhos[i] = (char *)memAlocar(MEM_TEXTOS, it.marca + 1);
+            if (!caminhos[i]) {
+                fprintf(stderr, "Erro ao alocar caminho.\n");
+                exit(EXIT_FAILURE);
+            }
+            memcpy(caminhos[i], caminho, it.marca);
+            caminhos[i][it.marca] = '\0';
+            tamanhos[i] = it.marca;
+            achados++;
+        }
+        if (topo + 2 > capPilha) pilha = (ItemBusca *)crescerVetor(pilha, &capPilha, sizeof(ItemBusca));
+        NoSala esq = filhoEsq(r, it.sala), dir = filhoDir(r, it.sala);
+        if (dir) pilha[topo++] = (ItemBusca){ dir, it.marca + 1, 'd' };
+        if (esq) pilha[topo++] = (ItemBusca){ esq, it.marca + 1, 'e' };
+    }
+    memLiberar(pilha);
+    memLiberar(caminho);
+}
+
+/* Solução em ordem alfabética de suspeito: a mesma listagem para a árvore
+   de ponteiros e para a forma compacta (que numeram suspeitos diferente). */
+static const char *const *nomesEmOrdenacao;
+
+static int compararNomesSolucao(const void *a, const void *b) {
+    return strcmp(nomesEmOrdenacao[*(const uint32_t *)a], nomesEmOrdenacao[*(const uint32_t *)b]);
+}
+
+static void imprimirSolucao(FILE *out, uint32_t K, const char *const *nomes, const int *melhor,
+                            char *const *caminhos, const char *const *fins) {
+    uint32_t *ordem = (uint32_t *)memAlocar(MEM_TRABALHO, (K + 1) * sizeof(uint32_t));
+    if (!ordem) {
+        fprintf(stderr, "Erro ao alocar resultados do resolvedor.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t k = 0; k < K; ++k) ordem[k] = k;
+    nomesEmOrdenacao = nomes;
+    qsort(ordem, K, sizeof(uint32_t), compararNomesSolucao);
+
+    fprintf(out, "\n=========== Solucao (melhor caminho por suspeito) ===========\n");
+    if (K == 0) fprintf(out, "(Nenhum suspeito associado a pistas)\n");
+    for (uint32_t i = 0; i < K; ++i) {
+        uint32_t k = ordem[i];
+        /* sala final = a da última pista contada: 'x' a revisita */
+        int revisita = (melhor[k] == 1);
+        fprintf(out, "- %s: %d pista(s) -> %s; caminho: %s%s (termina em %s)\n",
+                nomes[k], melhor[k],
+                melhor[k] >= 2 ? "CONDENAVEL" : revisita ? "CONDENAVEL revisitando" : "insuficiente",
+                caminhos[k][0] || revisita ? caminhos[k] : "-", revisita ? "x" : "", fins[k]);
+    }
+    fprintf(out, "=============================================================\n");
+    memLiberar(ordem);
+}
+
+/* resolverMansao() – imprime, por suspeito, a melhor contagem possível, se
+   ela condena (>= 2, a regra de verificarSuspeitoFinal, que conta também
+   as revisitas: ver acima) e o caminho, no
+   formato de movimentos do --replay (que lê a linha inteira, por longo
+   que seja o caminho numa mansão degenerada). Resolve a árvore (raiz + tabela) ou,
+   com caso != NULL, a forma compacta. */
+void resolverMansao(const Sala *raiz, const HashTable *ht, const CasoBinario *caso,
+                    int numThreads, FILE *out) {
+    if (!raiz && !(caso && caso->salas)) { fprintf(out, "Mapa inexistente.\n"); return; }
+    double t0 = agoraSegundos();
+
+    Resolvedor r;
+    memset(&r, 0, sizeof(r));
+    NoSala raizNo;
+    if (caso && caso->salas) {
+        r.caso = caso;
+        r.numSuspeitos = caso->numSuspeitos;
+        raizNo = noDoIndice(0);
+    } else {
+        r.ht = ht;
+        r.numIds = internos.quantidade;
+        r.compacto = (uint32_t *)memAlocar(MEM_TRABALHO, (r.numIds + 1) * sizeof(uint32_t));
+        r.idSuspeito = (uint32_t *)memAlocar(MEM_TRABALHO, (r.numIds + 1) * sizeof(uint32_t));
+        if (!r.compacto || !r.idSuspeito) {
+            fprintf(stderr, "Erro ao alocar resolvedor.\n");
+            exit(EXIT_FAILURE);
+        }
+        for (uint32_t i = 0; i < r.numIds; ++i) r.compacto[i] = ID_NENHUM;
+        for (size_t p = 0; p < ht->capacidade; ++p) {
+            uint32_t id = ht->suspeitoDaPista[p];
+            if (id < r.numIds && r.compacto[id] == ID_NENHUM) {
+                r.compacto[id] = r.numSuspeitos;
+                r.idSuspeito[r.numSuspeitos++] = id;
+            }
+        }
+        raizNo = (NoSala)raiz;
+    }
+    uint32_t K = r.numSuspeitos;
+
+    Fronteira fr;
+    abrirFronteira(&r, raizNo, numThreads > 1 ? (size_t)numThreads * SUBARVORES_POR_THREAD : 1, &fr);
+    size_t numSubs = fr.num;
+    Subarvore *subs = fr.subs;
+    TrabalhoResolver t;
+    t.r = &r;
+    t.subs = subs;
+    t.numSubs = numSubs;
+    t.melhor = (int *)memAlocar(MEM_TRABALHO, (numSubs * K + 1) * sizeof(int));
+    t.fim = (NoSala *)memAlocar(MEM_TRABALHO, (numSubs * K + 1) * sizeof(NoSala));
+    if (!t.melhor || !t.fim) {
+        fprintf(stderr, "Erro ao alocar resultados do resolvedor.\n");
+        exit(EXIT_FAILURE);
+    }
+#ifndef _WIN32
+    atomic_init(&t.proxima, 0);
+    pthread_t ids[MAX_THREADS];
+    int criadas = 0;
+    for (int i = 1; i < numThreads && i < MAX_THREADS; ++i) {
+        if (pthread_create(&ids[criadas], NULL, trabalharResolver, &t) != 0) break;
+        criadas++;
+    }
+    trabalharResolver(&t); /* a main também trabalha */
+    for (int i = 0; i < criadas; ++i) pthread_join(ids[i], NULL);
+#else
+    t.proxima = 0;
+    trabalharResolver(&t);
+#endif
+
+    /* junta: prefixo até a subárvore + melhor dentro dela. A primeira
+       subárvore (esquerda) com o máximo vence, como na busca sequencial;
+       se ela não acrescenta nada, a sala final é um ancestral. */
+    int *melhor = (int *)memZerada(MEM_TRABALHO, K + 1, sizeof(int));
+    size_t *vencedora = (size_t *)memZerada(MEM_TRABALHO, K + 1, sizeof(size_t));
+    NoSala *fim = (NoSala *)memAlocar(MEM_TRABALHO, (K + 1) * sizeof(NoSala));
+    char **caminhos = (char **)memZerada(MEM_TRABALHO, K + 1, sizeof(char *));
+    if (!melhor || !vencedora || !fim || !caminhos) {
+        fprintf(stderr, "Erro ao alocar resultados do resolvedor.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t k = 0; k < K; ++k) {
+        melhor[k] = -1;
+        for (size_t i = 0; i < numSubs; ++i) {
+            int v = fr.prefixo[i * K + k] + t.melhor[i * K + k];
+            if (v > melhor[k]) { melhor[k] = v; vencedora[k] = i; }
+        }
+        size_t pos = vencedora[k] * K + k;
+        if (t.melhor[pos] > 0) {
+            fim[k] = t.fim[pos];
+        } else {
+            size_t prof = fr.profUltimo[pos];
+            fim[k] = fr.ultimo[pos];
+            caminhos[k] = (char *)memAlocar(MEM_TEXTOS, prof + 1);
+            if (!caminhos[k]) {
+                fprintf(stderr, "Erro ao alocar caminho.\n");
+                exit(EXIT_FAILURE);
+            }
+            memcpy(caminhos[k], subs[vencedora[k]].caminho, prof);
+            caminhos[k][prof] = '\0';
+        }
+    }
+
+    /* caminhos: uma busca por subárvore vencedora, atrás das salas finais dela */
+    NoSala *alvos = (NoSala *)memAlocar(MEM_TRABALHO, (K + 1) * sizeof(NoSala));
+    char **achados = (char **)memAlocar(MEM_TRABALHO, (K + 1) * sizeof(char *));
+    size_t *tamAchados = (size_t *)memAlocar(MEM_TRABALHO, (K + 1) * sizeof(size_t));
+    if (!alvos || !achados || !tamAchados) {
+        fprintf(stderr, "Erro ao alocar caminhos do resolvedor.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t k = 0; k < K; ++k) {
+        if (caminhos[k]) continue;
+        size_t sub = vencedora[k], numAlvos = 0;
+        for (uint32_t j = k; j < K; ++j) {
+            if (vencedora[j] == sub && !caminhos[j]) alvos[numAlvos++] = fim[j];
+        }
+        qsort(alvos, numAlvos, sizeof(*alvos), compararNos);
+        size_t unicos = 0;
+        for (size_t i = 0; i < numAlvos; ++i) {
+            if (unicos == 0 || alvos[unicos - 1] != alvos[i]) alvos[unicos++] = alvos[i];
+        }
+        memset(achados, 0, unicos * sizeof(char *));
+        caminhosAte(&r, subs[sub].raiz, alvos, unicos, achados, tamAchados);
+
+        size_t tamPrefixo = strlen(subs[sub].caminho);
+        for (uint32_t j = k; j < K; ++j) {
+            if (vencedora[j] != sub || caminhos[j]) continue;
+            const NoSala *p = (const NoSala *)bsearch(&fim[j], alvos, unicos, sizeof(*alvos), compararNos);
+            size_t i = (size_t)(p - alvos);
+            caminhos[j] = (char *)memAlocar(MEM_TEXTOS, tamPrefixo + tamAchados[i] + 1);
+            if (!caminhos[j]) {
+                fprintf(stderr, "Erro ao alocar caminho.\n");
+                exit(EXIT_FAILURE);
+            }
+            memcpy(caminhos[j], subs[sub].caminho, tamPrefixo);
+            memcpy(caminhos[j] + tamPrefixo, achados[i], tamAchados[i] + 1);
+        }
+        for (size_t i = 0; i < unicos; ++i) memLiberar(achados[i]);
+    }
+    double tempo = agoraSegundos() - t0;
+
+    const char **nomes = (const char **)memAlocar(MEM_TRABALHO, (K + 1) * sizeof(char *));
+    const char **fins = (const char **)memAlocar(MEM_TRABALHO, (K + 1) * sizeof(char *));
+    if (!nomes || !fins) {
+        fprintf(stderr, "Erro ao alocar resultados do resolvedor.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t k = 0; k < K; ++k) {
+        nomes[k] = r.caso ? casoTexto(r.caso, r.caso->suspeitos[k]) : textoInterno(r.idSuspeito[k]);
+        fins[k] = nomeDoNo(&r, fim[k]);
+    }
+    imprimirSolucao(out, K, nomes, melhor, caminhos, fins);
+    fprintf(stderr, "resolvido em %.3f s (%zu subarvores, %d threads%s)\n", tempo, numSubs,
+            numThreads > 1 ? numThreads : 1, r.caso ? ", forma compacta" : "");
+
+    for (uint32_t k = 0; k < K; ++k) memLiberar(caminhos[k]);
+    memLiberar((void *)nomes); memLiberar((void *)fins);
+    memLiberar(alvos); memLiberar(achados); memLiberar(tamAchados);
+    memLiberar(melhor); memLiberar(vencedora); memLiberar(fim); memLiberar(caminhos);
+    memLiberar(t.melhor); memLiberar((void *)t.fim);
+    memLiberar(fr.subs); memLiberar(fr.prefixo); memLiberar((void *)fr.ultimo); memLiberar(fr.profUltimo);
+    memLiberar(r.compacto); memLiberar(r.idSuspeito);
+}
+
+/* ===================== Gerador de mansões (--gerar) ===================== */
+/* --gerar forma:salas[:semente[:densidade[:suspeitos]]]
+     forma      balanceada | degenerada | aleatoria
+     salas      quantidade de cômodos (até ~10^8, limitado pela memória)
+     semente    mesma semente, mesma mansão (padrão 1)
+     densidade  % de salas com pista (padrão 60)
+     suspeitos  quantidade de suspeitos (padrão 8); há 4 pistas por suspeito
+
+   Cada sala deriva tudo (nome, pista, formato da subárvore) só da própria
+   semente, e as sementes dos filhos derivam da do pai: a mansão não depende
+   da ordem de construção nem do número de threads. As primeiras subárvores
+   são abertas na thread principal; depois cada thread constrói subárvores
+   inteiras na própria arena. A degenerada (uma lista) é cortada em trechos
+   contíguos, ligados no fim.
+
+   O resultado é uma árvore de Sala comum: serve para jogar, para --replay,
+   --resolver e --exportar-caso (e, pelo .dqc, para os outros capítulos).
+   Nomes de sala gerados não são internados (idNome = ID_NENHUM): são
+   únicos e só servem para exibição. */
+
+typedef enum { FORMA_BALANCEADA, FORMA_DEGENERADA, FORMA_ALEATORIA } FormaMansao;
+
+typedef struct ParametrosMansao {
+    FormaMansao forma;
+    uint64_t salas;
+    uint64_t semente;
+    unsigned densidade;          /* % de salas com pista (0..100) */
+    unsigned suspeitos;          /* >= 1 */
+} ParametrosMansao;
+
+typedef struct MansaoGerada {
+    Sala *raiz;
+    Arena *arenas;               /* uma por thread de construção */
+    int numArenas;
+} MansaoGerada;
+
+#define PISTAS_POR_SUSPEITO 4
+#define SALAS_POR_TAREFA_MIN 4096
+
+static const char *TIPOS_SALA[] = {
+    "Sala de Estar", "Corredor", "Biblioteca", "Cozinha", "Escritorio",
+    "Jardim", "Adega", "Deposito", "Despensa", "Estufa", "Salao de Baile",
+    "Quarto", "Sotao", "Capela", "Galeria",
+};
+static const char *OBJETOS_PISTA[] = {
+    "Pegadas de lama", "Luva de couro", "Bilhete rasgado", "Chave dourada",
+    "Perfume forte", "Taca com batom", "Livro raro", "Terra revolvida",
+};
+static const char *TITULOS[]    = { "Sr.", "Sra.", "Dr.", "Dra.", "Coronel", "Professor" };
+static const char *SOBRENOMES[] = { "Mostarda", "Violeta", "Orquidea", "Carvalho", "Branca", "Pavao", "Ameixa", "Marfim" };
+#define NUM_DE(v) (sizeof(v) / sizeof((v)[0]))
+
+/* splitmix64: espalha sementes vizinhas em valores independentes */
+static uint64_t misturar(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+typedef struct Gerador {
+    const ParametrosMansao *p;
+    uint32_t *idsPistas;         /* pistas internadas (PISTAS_POR_SUSPEITO por suspeito) */
+    uint32_t numPistas;
+} Gerador;
+
+/* Sala de índice 'indice' (numera o nome) com a semente dada. */
+static Sala *salaGerada(Arena *a, const Gerador *g, uint64_t indice, uint64_t semente) {
+    char nome[48];
+    if (indice == 0) snprintf(nome, sizeof(nome), "Hall de Entrada");
+    else snprintf(nome, sizeof(nome), "%s %llu", TIPOS_SALA[semente % NUM_DE(TIPOS_SALA)],
+                  (unsigned long long)indice);
+    Sala *s = (Sala *)arenaAlocar(a, sizeof(Sala), MEM_SALAS);
+    EST_REGISTRAR(bytesCriarSala, sizeof(Sala));
+    s->nome = arenaDuplicaString(a, nome, MEM_NOMES);
+    s->idNome = ID_NENHUM;
+    uint64_t h = misturar(semente ^ 0x5A17A5ull);
+    s->pista = (h % 100 < g->p->densidade) ? g->idsPistas[(h >> 32) % g->numPistas] : ID_NENHUM;
+    s->esq = s->dir = NULL;
+    return s;
+}
+
+/* Subárvore por construir: n salas, raiz com índice 'base' (pré-ordem). */
+typedef struct TarefaGeracao {
+    Sala **link;                 /* onde pendurar a raiz */
+    uint64_t n, base, semente;
+} TarefaGeracao;
+
+/* Quantas salas vão para a esquerda de uma raiz com n salas na subárvore. */
+static uint64_t tamanhoEsquerda(const Gerador *g, uint64_t n, uint64_t semente) {
+    if (g->p->forma == FORMA_BALANCEADA) return (n - 1) / 2;
+    return misturar(semente ^ 0xE5Cull) % n; /* aleatória: 0..n-1 */
+}
+
+/* Cria a raiz da tarefa e empilha as subárvores dos filhos. */
+static void abrirTarefa(Arena *a, const Gerador *g, TarefaGeracao t, TarefaGeracao *esq, TarefaGeracao *dir) {
+    Sala *s = salaGerada(a, g, t.base, t.semente);
+    *t.link = s;
+    uint64_t ne = tamanhoEsquerda(g, t.n, t.semente);
+    *esq = (TarefaGeracao){ &s->esq, ne, t.base + 1, misturar(t.semente ^ 0x1Eull) };
+    *dir = (TarefaGeracao){ &s->dir, t.n - 1 - ne, t.base + 1 + ne, misturar(t.semente ^ 0xD1Dull) };
+}
+
+/* Constrói a subárvore inteira, sem recursão. */
+static void construirSubarvore(Arena *a, const Gerador *g, TarefaGeracao raiz) {
+    size_t cap = 64, topo = 0;
+    TarefaGeracao *pilha = (TarefaGeracao *)memAlocar(MEM_TRABALHO, cap * sizeof(TarefaGeracao));
+    if (!pilha) {
+        fprintf(stderr, "Erro ao alocar pilha do gerador.\n");
+        exit(EXIT_FAILURE);
+    }
+    pilha[topo++] = raiz;
+    while (topo > 0) {
+        TarefaGeracao t = pilha[--topo];
+        if (t.n == 0) continue;
+        if (topo + 2 > cap) {
+            TarefaGeracao *nova = (TarefaGeracao *)memRealocar(MEM_TRABALHO, pilha, 2 * cap * sizeof(TarefaGeracao));
+            if (!nova) {
+                fprintf(stderr, "Erro ao alocar pilha do gerador.\n");
+                exit(EXIT_FAILURE);
+            }
+            pilha = nova;
+            cap *= 2;
+        }
+        abrirTarefa(a, g, t, &pilha[topo + 1], &pilha[topo]);
+        topo += 2;
+    }
+    memLiberar(pilha);
+}
+
+/* Degenerada: sala j da lista, e de que lado fica a seguinte. */
+static uint64_t sementeDaLista(const Gerador *g, uint64_t j) {
+    return misturar(g->p->semente ^ (j * 0x9E3779B97F4A7C15ull));
+}
+
+/* Trecho [ini, fim) da lista; devolve a primeira sala e a última em *ultima. */
+static Sala *construirTrecho(Arena *a, const Gerador *g, uint64_t ini, uint64_t fim, Sala **ultima) {
+    Sala *primeira = NULL, *anterior = NULL;
+    for (uint64_t j = ini; j < fim; ++j) {
+        uint64_t sem = sementeDaLista(g, j);
+        Sala *s = salaGerada(a, g, j, sem);
+        if (anterior) {
+            if ((sementeDaLista(g, j - 1) >> 63) & 1) anterior->dir = s;
+            else                                      anterior->esq = s;
+        } else {
+            primeira = s;
+        }
+        anterior = s;
+    }
+    *ultima = anterior;
+    return primeira;
+}
+
+typedef struct TrabalhoGeracao {
+    const Gerador *g;
+    TarefaGeracao *tarefas;      /* subárvores (ou trechos, na degenerada) */
+    size_t numTarefas;
+    Sala **primeiras, **ultimas; /* degenerada: pontas de cada trecho */
+    Arena *arenas;
+#ifndef _WIN32
+    atomic_size_t proxima;
+#else
+    size_t proxima;
+#endif
+} TrabalhoGeracao;
+
+typedef struct ConstrutorGeracao {
+    TrabalhoGeracao *t;
+    int indice;
+} ConstrutorGeracao;
+
+static void *trabalharGeracao(void *arg) {
+    ConstrutorGeracao *c = (ConstrutorGeracao *)arg;
+    TrabalhoGeracao *t = c->t;
+    Arena *a = &t->arenas[c->indice];
+    for (;;) {
+#ifndef _WIN32
+        size_t i = atomic_fetch_add_explicit(&t->proxima, 1, memory_order_relaxed);
+#else
+        size_t i = t->proxima++;
+#endif
+        if (i >= t->numTarefas) break;
+        if (t->g->p->forma == FORMA_DEGENERADA) {
+            t->primeiras[i] = construirTrecho(a, t->g, t->tarefas[i].base,
+                                              t->tarefas[i].base + t->tarefas[i].n, &t->ultimas[i]);
+        } else {
+            construirSubarvore(a, t->g, t->tarefas[i]);
+        }
+    }
+    EST_ENTREGAR_THREAD();
+    return NULL;
+}
+
+/* lerParametrosMansao() – "forma:salas[:semente[:densidade[:suspeitos]]]". */
+int lerParametrosMansao(const char *spec, ParametrosMansao *p) {
+    char forma[16];
+    unsigned long long salas = 0, semente = 1;
+    unsigned densidade = 60, suspeitos = 8;
+    int lidos = sscanf(spec, "%15[^:]:%llu:%llu:%u:%u", forma, &salas, &semente, &densidade, &suspeitos);
+    if (lidos < 2 || salas == 0 || densidade > 100 || suspeitos == 0) return -1;
+    if      (strcmp(forma, "balanceada") == 0) p->forma = FORMA_BALANCEADA;
+    else if (strcmp(forma, "degenerada") == 0) p->forma = FORMA_DEGENERADA;
+    else if (strcmp(forma, "aleatoria") == 0)  p->forma = FORMA_ALEATORIA;
+    else return -1;
+    p->salas = salas;
+    p->semente = semente;
+    p->densidade = densidade;
+    p->suspeitos = suspeitos;
+    return 0;
+}
+
+/* gerarMansao() – constrói a mansão e registra pistas/suspeitos em ht. */
+MansaoGerada gerarMansao(const ParametrosMansao *p, HashTable *ht, int numThreads) {
+    MansaoGerada m;
+    Gerador g;
+    double t0 = agoraSegundos();
+    if (numThreads < 1) numThreads = 1;
+
+    /* suspeitos e pistas: poucos, internados como os da mansão embutida */
+    g.p = p;
+    g.numPistas = p->suspeitos * PISTAS_POR_SUSPEITO;
+    g.idsPistas = (uint32_t *)memAlocar(MEM_TRABALHO, g.numPistas * sizeof(uint32_t));
+    if (!g.idsPistas) {
+        fprintf(stderr, "Erro ao alocar pistas geradas.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t i = 0; i < g.numPistas; ++i) {
+        char pista[64], suspeito[64];
+        uint32_t k = i % p->suspeitos;
+        snprintf(pista, sizeof(pista), "%s %u", OBJETOS_PISTA[i % NUM_DE(OBJETOS_PISTA)], i + 1);
+        const char *titulo = TITULOS[(k + k / NUM_DE(SOBRENOMES)) % NUM_DE(TITULOS)];
+        if (k < NUM_DE(TITULOS) * NUM_DE(SOBRENOMES)) {
+            snprintf(suspeito, sizeof(suspeito), "%s %s", titulo, SOBRENOMES[k % NUM_DE(SOBRENOMES)]);
+        } else {
+            snprintf(suspeito, sizeof(suspeito), "%s %s %u", titulo, SOBRENOMES[k % NUM_DE(SOBRENOMES)], k + 1);
+        }
+        inserirNaHash(ht, pista, suspeito);
+        g.idsPistas[i] = buscarInterno(pista);
+    }
+
+    m.raiz = NULL;
+    m.numArenas = numThreads;
+    m.arenas = (Arena *)memZerada(MEM_TRABALHO, (size_t)numThreads, sizeof(Arena));
+    TrabalhoGeracao t;
+    memset(&t, 0, sizeof(t));
+    t.g = &g;
+    t.arenas = m.arenas;
+    size_t alvo = (size_t)numThreads * 8;
+
+    if (p->forma == FORMA_DEGENERADA) {
+        /* trechos contíguos da lista, ligados depois */
+        uint64_t trechos = (numThreads > 1 && p->salas >= alvo * SALAS_POR_TAREFA_MIN) ? alvo : 1;
+        t.numTarefas = (size_t)trechos;
+        t.tarefas = (TarefaGeracao *)memZerada(MEM_TRABALHO, t.numTarefas, sizeof(TarefaGeracao));
+        t.primeiras = (Sala **)memZerada(MEM_TRABALHO, t.numTarefas, sizeof(Sala *));
+        t.ultimas = (Sala **)memZerada(MEM_TRABALHO, t.numTarefas, sizeof(Sala *));
+        for (size_t i = 0; t.tarefas && i < t.numTarefas; ++i) {
+            t.tarefas[i].base = p->salas * i / trechos;
+            t.tarefas[i].n = p->salas * (i + 1) / trechos - t.tarefas[i].base;
+        }
+    } else {
+        /* abre os primeiros níveis (na arena 0) até ter subárvores bastantes */
+        size_t cap = 2 * alvo + 2, n = 0;
+        t.tarefas = (TarefaGeracao *)memAlocar(MEM_TRABALHO, cap * sizeof(TarefaGeracao));
+        TarefaGeracao *prox = (TarefaGeracao *)memAlocar(MEM_TRABALHO, cap * sizeof(TarefaGeracao));
+        if (!t.tarefas || !prox) {
+            fprintf(stderr, "Erro ao alocar tarefas do gerador.\n");
+            exit(EXIT_FAILURE);
+        }
+        t.tarefas[n++] = (TarefaGeracao){ &m.raiz, p->salas, 0, misturar(p->semente) };
+        while (numThreads > 1 && n < alvo) {
+            size_t k = 0;
+            int abriu = 0;
+            for (size_t i = 0; i < n; ++i) {
+                if (t.tarefas[i].n < SALAS_POR_TAREFA_MIN || k + 2 > cap) {
+                    if (t.tarefas[i].n) prox[k++] = t.tarefas[i];
+                    continue;
+                }
+                TarefaGeracao e, d;
+                abrirTarefa(&m.arenas[0], &g, t.tarefas[i], &e, &d);
+                if (e.n) prox[k++] = e;
+                if (d.n) prox[k++] = d;
+                abriu = 1;
+            }
+            TarefaGeracao *tmp = t.tarefas;
+            t.tarefas = prox;
+            prox = tmp;
+            n = k;
+            if (!abriu) break;
+        }
+        memLiberar(prox);
+        t.numTarefas = n;
+    }
+    if (!m.arenas || !t.tarefas || (p->forma == FORMA_DEGENERADA && (!t.primeiras || !t.ultimas))) {
+        fprintf(stderr, "Erro ao alocar tarefas do gerador.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    ConstrutorGeracao construtores[MAX_THREADS];
+    for (int i = 0; i < numThreads; ++i) construtores[i] = (ConstrutorGeracao){ &t, i };
+#ifndef _WIN32
+    atomic_init(&t.proxima, 0);
+    pthread_t ids[MAX_THREADS];
+    int criadas = 0;
+    for (int i = 1; i < numThreads; ++i) {
+        if (pthread_create(&ids[criadas], NULL, trabalharGeracao, &construtores[i]) != 0) break;
+        criadas++;
+    }
+    trabalharGeracao(&construtores[0]);
+    for (int i = 0; i < criadas; ++i) pthread_join(ids[i], NULL);
+#else
+    t.proxima = 0;
+    trabalharGeracao(&construtores[0]);
+#endif
+
+    if (p->forma == FORMA_DEGENERADA) {
+        for (size_t i = 0; i + 1 < t.numTarefas; ++i) {
+            uint64_t ultimaJ = t.tarefas[i].base + t.tarefas[i].n - 1;
+            if ((sementeDaLista(&g, ultimaJ) >> 63) & 1) t.ultimas[i]->dir = t.primeiras[i + 1];
+            else                                         t.ultimas[i]->esq = t.primeiras[i + 1];
+        }
+        m.raiz = t.primeiras[0];
+    }
+    fprintf(stderr, "mansao gerada: %llu salas, %u suspeitos, %zu tarefas, %d threads, %.3f s\n",
+            (unsigned long long)p->salas, p->suspeitos, t.numTarefas, numThreads, agoraSegundos() - t0);
+
+    memLiberar(t.tarefas);
+    memLiberar(t.primeiras);
+    memLiberar(t.ultimas);
+    memLiberar(g.idsPistas);
+    return m;
+}
+
+void liberarMansaoGerada(MansaoGerada *m) {
+    for (int i = 0; i < m->numArenas; ++i) arenaLiberar(&m->arenas[i]);
+    memLiberar(m->arenas);
+    m->arenas = NULL;
+    m->numArenas = 0;
+    m->raiz = NULL;
+}
+
+/* ======================== Montagem do Mapa ======================== */
+/*
+   Layout fixo (mesmo do capítulo anterior):
+
+                 [Hall de Entrada]
+                   /           \
+         [Sala de Estar]     [Corredor]
+            /      \           /     \
+     [Biblioteca] [Cozinha] [Escritorio] [Jardim]
+        /     \         \                    \
+    [Adega] [Deposito] [Despensa]          [Estufa]
+*/
+Sala *montarMapa(Arena *a) {
+    Sala *hall        = criarSala(a, "Hall de Entrada");
+    Sala *estar       = criarSala(a, "Sala de Estar");
+    Sala *corredor    = criarSala(a, "Corredor");
+    Sala *biblio      = criarSala(a, "Biblioteca");
+    Sala *cozinha     = criarSala(a, "Cozinha");
+    Sala *escritorio  = criarSala(a, "Escritorio");
+    Sala *jardim      = criarSala(a, "Jardim");
+    Sala *adega       = criarSala(a, "Adega");
+    Sala *deposito    = criarSala(a, "Deposito");
+    Sala *despensa    = criarSala(a, "Despensa");
+    Sala *estufa      = criarSala(a, "Estufa");
+
+    hall->esq = estar;      hall->dir = corredor;
+    estar->esq = biblio;    estar->dir = cozinha;
+    corredor->esq = escritorio; corredor->dir = jardim;
+    biblio->esq = adega;    biblio->dir = deposito;
+    cozinha->dir = despensa;
+    jardim->dir = estufa;
+
+    return hall; /* raiz */
+}
+
+/* ======================= Povoamento da Hash ======================= */
+/* Popula a tabela hash com associações pista -> suspeito.
+   Ajuste os nomes para o enredo desejado. */
+void popularMapaPistas(HashTable *ht) {
+    /* Suspeitos de exemplo */
+    /* - Sr. Mostarda
+       - Srta. Violeta
+       - Coronel Mostarda (se preferir variação)
+       - Dra. Orquidea
+       - Professor Carvalho
+       - Sra. Branca
+       - Jardineiro */
+
+    inserirNaHash(ht, "Pegadas de lama",        "Jardineiro");
+    inserirNaHash(ht, "Almofada fora do lugar", "Sra. Branca");
+    inserirNaHash(ht, "Perfume forte",          "Srta. Violeta");
+    inserirNaHash(ht, "Livro raro deslocado",   "Professor Carvalho");
+    inserirNaHash(ht, "Janela entreaberta",     "Sr. Mostarda");
+    inserirNaHash(ht, "Luva de couro",          "Sr. Mostarda");
+    inserirNaHash(ht, "Taca com batom",         "Srta. Violeta");
+    inserirNaHash(ht, "Rastro de acucar",       "Dra. Orquidea");
+    inserirNaHash(ht, "Terra revolvida",        "Jardineiro");
+
+    /* Alias com acentos removidos nos textos das pistas para simplificar
+       comparação em ambientes sem locale configurado. */
+}
+
+/* ===================== Forma compacta (planificação) ===================== */
+/* A árvore de Sala é cômoda para montar, mas cada passo da descida segue
+   um ponteiro para um nó de 32 bytes e outro para o nome, em endereços
+   quaisquer. A forma compacta é o layout do caso binário montado em
+   memória: um vetor de CasoSala (16 bytes, filhos em índices de 32 bits)
+   mais um bloco de textos separado, que só é tocado para imprimir. Tudo o
+   que joga sobre um CasoBinario (explorarCaso, --replay, --resolver) passa
+   a valer para mansões embutidas ou geradas.
+
+   Ordem das salas: o arquivo (exportarCaso) usa BFS; a forma compacta em
+   memória usa pré-ordem – o filho da esquerda é a sala seguinte (mesma
+   linha de cache) e cada subárvore é um trecho contíguo, então a busca do
+   resolvedor lê o vetor em sequência e uma descida ao acaso erra o cache
+   em cerca de metade dos níveis fundos, contra todos em BFS. */
+
+typedef enum { ORDEM_BFS, ORDEM_PREORDEM } OrdemSalas;
+
+typedef struct SalaPendente {
+    const Sala *sala;
+    uint32_t pai;                /* índice já atribuído ao pai (CASO_NENHUM na raiz) */
+    char lado;                   /* 'e' ou 'd' */
+} SalaPendente;
+
+/* planificarMansao() – copia a mansão para o escritor (o Hall recebe o
+   índice 0), com pistas (Sala::pista) e suspeitos (tabela). Em BFS as
+   salas saem do início do vetor de pendentes; em pré-ordem, do fim. */
+static void planificarMansao(const Sala *raiz, const HashTable *ht, OrdemSalas ordem, CasoEscritor *e) {
+    memset(e, 0, sizeof(*e));
+    size_t cap = 16, ini = 0, fim = 0;
+    SalaPendente *pend = (SalaPendente *)memAlocar(MEM_TRABALHO, cap * sizeof(SalaPendente));
+    if (!pend) {
+        fprintf(stderr, "Erro ao alocar fila de exportacao.\n");
+        exit(EXIT_FAILURE);
+    }
+    pend[fim++] = (SalaPendente){ raiz, CASO_NENHUM, 0 };
+
+    while (ini < fim) {
+        SalaPendente it = (ordem == ORDEM_BFS) ? pend[ini++] : pend[--fim];
+        const Sala *s = it.sala;
+        uint32_t idxPista = CASO_NENHUM;
+        if (s->pista != ID_NENHUM) {
+            const char *sus = textoInterno(encontrarSuspeitoId(ht, s->pista));
+            idxPista = escritorPista(e, textoInterno(s->pista), sus);
+        }
+        uint32_t i = escritorSala(e, s->nome, idxPista);
+        if (it.lado == 'e') e->salas[it.pai].esq = i;
+        if (it.lado == 'd') e->salas[it.pai].dir = i;
+
+        if (fim + 2 > cap) {
+            cap *= 2;
+            SalaPendente *nova = (SalaPendente *)memRealocar(MEM_TRABALHO, pend, cap * sizeof(SalaPendente));
+            if (!nova) {
+                fprintf(stderr, "Erro ao alocar fila de exportacao.\n");
+                exit(EXIT_FAILURE);
+            }
+            pend = nova;
+        }
+        /* BFS: esquerda antes; pré-ordem (pilha): esquerda por último, sai primeiro */
+        if (ordem == ORDEM_BFS) {
+            if (s->esq) pend[fim++] = (SalaPendente){ s->esq, i, 'e' };
+            if (s->dir) pend[fim++] = (SalaPendente){ s->dir, i, 'd' };
+        } else {
+            if (s->dir) pend[fim++] = (SalaPendente){ s->dir, i, 'd' };
+            if (s->esq) pend[fim++] = (SalaPendente){ s->esq, i, 'e' };
+        }
+    }
+    memLiberar(pend);
+
+    /* suspeitos cujas pistas não caíram em nenhuma sala também constam */
+    for (size_t p = 0; p < ht->capacidade; ++p) {
+        uint32_t sus = ht->suspeitoDaPista[p];
+        if (sus != ID_NENHUM) escritorSuspeito(e, textoInterno(sus));
+    }
+}
+
+/* compactarMansao() – converte a árvore de ponteiros para a forma compacta
+   em memória. A árvore original continua válida (quem chama a libera). */
+void compactarMansao(const Sala *raiz, const HashTable *ht, CasoBinario *c) {
+    CasoEscritor e;
+    planificarMansao(raiz, ht, ORDEM_PREORDEM, &e);
+    casoDoEscritor(&e, c);
+    casoOrdenarPistas(c);
+}
+
+/* exportarCaso() – grava a forma compacta da mansão em formato binário. */
+int exportarCaso(Sala *raiz, HashTable *ht, const char *caminho) {
+    CasoEscritor e;
+    planificarMansao(raiz, ht, ORDEM_BFS, &e);
+    int r = gravarCaso(&e, caminho);
+    liberarEscritor(&e);
+    return r;
+}
+
+/* ===================== Mansão em grafo (--grafo) ===================== */
+/* --grafo extras[:semente]
+     extras   saídas a mais por sala, para salas quaisquer (padrão 0)
+     semente  mesma semente, mesmas saídas (padrão 1)
+
+   A árvore só deixa descer: no máximo duas saídas e nenhum caminho de
+   volta. Com --grafo, as salas do caso (compacto, --caso ou estático)
+   ganham um grafo de saídas por cima: os filhos, a porta de volta para o
+   pai e 'extras' passagens derivadas da semente (ciclos e atalhos). Nomes,
+   pistas e suspeitos continuam vindo do caso, pelo mesmo índice de sala.
+
+   As saídas ficam em CSR (linhas comprimidas): as de s são
+   destino[inicio[s] .. inicio[s + 1]), um trecho contíguo lido em ordem,
+   e o grafo inteiro são dois vetores de 32 bits – 4 bytes por aresta
+   mais 4 por sala, sem nó nem ponteiro por saída. Andar é trocar o índice
+   da sala atual; 'v' desfaz a última jogada pela pilha de salas visitadas
+   (o histórico, não a porta do pai). */
+
+typedef struct GrafoMansao {
+    uint32_t numSalas;
+    uint32_t *inicio;            /* numSalas + 1 posições em destino[] */
+    uint32_t *destino;           /* saídas, sala por sala */
+} GrafoMansao;
+
+/* saidasDaSala() – saídas de i, sem repetição nem laço para si mesma:
+   filhos, pai e extras, nesta ordem. Devolve quantas escreveu em out[]. */
+static uint32_t saidasDaSala(const CasoBinario *c, const uint32_t *pai, uint32_t i,
+                             uint32_t extras, uint64_t semente, uint32_t *out) {
+    uint32_t n = 0;
+    uint32_t fixas[3] = { casoEsq(c, i), casoDir(c, i), pai[i] };
+    for (int k = 0; k < 3; ++k) {
+        if (fixas[k] != CASO_NENHUM) out[n++] = fixas[k];
+    }
+    for (uint32_t k = 0; k < extras && c->numSalas > 1; ++k) {
+        uint32_t d = (uint32_t)(misturar(semente ^ ((uint64_t)i << 20) ^ k) % c->numSalas);
+        int repetida = (d == i);
+        for (uint32_t j = 0; j < n && !repetida; ++j) repetida = (out[j] == d);
+        if (!repetida) out[n++] = d;
+    }
+    return n;
+}
+
+/* montarGrafo() – duas varreduras lineares do caso: conta as saídas de
+   cada sala (prefixos em inicio[]) e depois as escreve no lugar. */
+void montarGrafo(const CasoBinario *c, uint32_t extras, uint64_t semente, GrafoMansao *g) {
+    uint32_t N = c->numSalas;
+    uint32_t *pai = (uint32_t *)memAlocar(MEM_TRABALHO, (size_t)N * sizeof(uint32_t));
+    uint32_t *saidas = (uint32_t *)memAlocar(MEM_TRABALHO, ((size_t)extras + 3) * sizeof(uint32_t));
+    g->numSalas = N;
+    g->inicio = (uint32_t *)memAlocar(MEM_SALAS, ((size_t)N + 1) * sizeof(uint32_t));
+    if (!pai || !saidas || !g->inicio) {
+        fprintf(stderr, "Erro ao alocar grafo da mansao.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t i = 0; i < N; ++i) pai[i] = CASO_NENHUM;
+    for (uint32_t i = 0; i < N; ++i) {
+        if (casoEsq(c, i) != CASO_NENHUM) pai[casoEsq(c, i)] = i;
+        if (casoDir(c, i) != CASO_NENHUM) pai[casoDir(c, i)] = i;
+    }
+
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < N; ++i) {
+        g->inicio[i] = (uint32_t)total;
+        total += saidasDaSala(c, pai, i, extras, semente, saidas);
+        if (total > UINT32_MAX) {
+            fprintf(stderr, "Erro: grafo com mais de %u saidas.\n", UINT32_MAX);
+            exit(EXIT_FAILURE);
+        }
+    }
+    g->inicio[N] = (uint32_t)total;
+
+    g->destino = (uint32_t *)memAlocar(MEM_SALAS, (size_t)(total ? total : 1) * sizeof(uint32_t));
+    if (!g->destino) {
+        fprintf(stderr, "Erro ao alocar grafo da mansao.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t i = 0; i < N; ++i) saidasDaSala(c, pai, i, extras, semente, g->destino + g->inicio[i]);
+    memLiberar(saidas);
+    memLiberar(pai);
+}
+
+void liberarGrafo(GrafoMansao *g) {
+    memLiberar(g->inicio);
+    memLiberar(g->destino);
+    memset(g, 0, sizeof(*g));
+}
+
+/* lerParametrosGrafo() – "extras[:semente]". */
+int lerParametrosGrafo(const char *spec, uint32_t *extras, uint64_t *semente) {
+    unsigned long long s = 1;
+    unsigned e = 0;
+    int lidos = sscanf(spec, "%u:%llu", &e, &s);
+    if (lidos < 1 || e > 64) return -1;
+    *extras = e;
+    *semente = s;
+    return 0;
+}
+
+/* explorarGrafo() – a exploração de explorarCaso() sobre o grafo: saídas
+   numeradas (1..k), 'v' volta para a sala anterior, 's' sai. Revisitar uma
+   sala coleta a pista de novo, como a jogada inválida na árvore. Com
+   viagem != NULL, 'i' também vale: a rota pela árvore existe no grafo
+   (filhos e portas de volta), e a viagem entra no histórico. */
+void explorarGrafo(Arena *sessao, const CasoBinario *c, const GrafoMansao *g, Evidencias *ev,
+                   const Viagem *viagem) {
+    uint32_t atual = 0; /* sala 0 = Hall */
+    uint8_t *visitadas = criarVisitadas(sessao, viagem, c);
+    size_t cap = 64, topo = 0;
+    uint32_t *historico = (uint32_t *)memAlocar(MEM_TRABALHO, cap * sizeof(uint32_t));
+    if (!historico) {
+        fprintf(stderr, "Erro ao alocar historico da exploracao.\n");
+        exit(EXIT_FAILURE);
+    }
+    textoMenu("\n==============================================\n");
+    textoMenu("    Detective Quest - Exploracao Final        \n");
+    textoMenu("==============================================\n");
+
+    while (1) {
+        printf("\nVoce esta em: %s\n", casoNomeSala(c, atual));
+        marcarVisitada(visitadas, atual);
+
+        uint32_t idx = casoPistaIdx(c, atual);
+        if (idx != CASO_NENHUM) {
+            const char *p = casoPistaSala(c, atual);
+            const char *sus = casoSuspeitoPista(c, idx);
+            registrarPista(sessao, ev, idx, c->ordemPistas[idx], p, casoSuspeitoIdx(c, idx));
+            if (sus) {
+                printf("Pista encontrada: \"%s\" -> suspeito associado: %s\n", p, sus);
+            } else {
+                printf("Pista encontrada: \"%s\" (sem suspeito associado)\n", p);
+            }
+        } else {
+            printf("Nenhuma pista encontrada aqui.\n");
+        }
+
+        const uint32_t *saidas = g->destino + g->inicio[atual];
+        uint32_t numSaidas = g->inicio[atual + 1] - g->inicio[atual];
+        textoMenu("\nSaidas a partir de \"%s\":\n", casoNomeSala(c, atual));
+        for (uint32_t k = 0; k < numSaidas; ++k) textoMenu("  (%u) %s\n", k + 1, casoNomeSala(c, saidas[k]));
+        if (topo > 0) textoMenu("  (v) Voltar: %s\n", casoNomeSala(c, historico[topo - 1]));
+        if (viagem) textoMenu("  (i) Ir para uma sala ja visitada\n");
+        textoMenu("  (s) Sair da exploracao\n");
+        textoMenu(viagem ? "Escolha [1-%u/v/i/s]: " : "Escolha [1-%u/v/s]: ", numSaidas);
+
+        char op = lerOpcao();
+        uint32_t proxima = CASO_NENHUM;
+        if (op == 's') {
+            printf("\nExploracao encerrada pelo jogador.\n");
+            break;
+        } else if (op == COMANDO_SAIDA) {
+            if (numeroComando == 0 || numeroComando > numSaidas) {
+                printf("Nao ha saida %u.\n", numeroComando);
+                continue;
+            }
+            proxima = saidas[numeroComando - 1];
+        } else if (op == 'i' && viagem) {
+            proxima = pedirViagem(c, viagem, visitadas, atual);
+        } else if (op == 'v') {
+            if (topo == 0) { printf("Nao ha para onde voltar.\n"); continue; }
+            atual = historico[--topo];
+        } else {
+            printf("Opcao invalida. Use o numero da saida, 'v' ou 's'.\n");
+        }
+        if (proxima != CASO_NENHUM) {
+            if (topo == cap) {
+                cap *= 2;
+                uint32_t *novo = (uint32_t *)memRealocar(MEM_TRABALHO, historico, cap * sizeof(uint32_t));
+                if (!novo) {
+                    fprintf(stderr, "Erro ao alocar historico da exploracao.\n");
+                    exit(EXIT_FAILURE);
+                }
+                historico = novo;
+            }
+            historico[topo++] = atual;
+            atual = proxima;
+        }
+    }
+    descartarComandos();
+    memLiberar(historico);
+}
+
+/* ===================== Caso estático (opcional) ===================== */
+/* Compilando com -DDQ_CASO_ESTATICO, a mansão vem de tabelas "static const"
+   geradas por A5_gerarTabelasCaso.c e embutidas no binário: a partida
+   começa sem nenhuma alocação e sem nenhum hash. Sem a flag, montarMapa(),
+   popularMapaPistas() e pistaDaSala() continuam sendo o caminho padrão.
+
+   Regenerar após mudar o mapa embutido:
+     gcc -o detetiveMestre A5_detetiveMestre.c
+     ./detetiveMestre --exportar-caso mansao.dqc
+     gcc -o gerarTabelasCaso A5_gerarTabelasCaso.c
+     ./gerarTabelasCaso mansao.dqc > A5_casoMansao.h */
+#ifdef DQ_CASO_ESTATICO
+#include "A5_casoMansao.h"
+
+static inline void abrirCasoEstatico(CasoBinario *c) {
+    memset(c, 0, sizeof(*c));
+    c->salas        = casoEstaticoSalas;
+    c->pistas       = casoEstaticoPistas;
+    c->suspeitos    = casoEstaticoSuspeitos;
+    c->textos       = casoEstaticoTextos;
+    c->tamTextos    = sizeof(casoEstaticoTextos) - 1; /* sem o '\0' implícito do literal */
+    c->numSalas     = CASO_ESTATICO_NUM_SALAS;
+    c->numPistas    = CASO_ESTATICO_NUM_PISTAS;
+    c->numSuspeitos = CASO_ESTATICO_NUM_SUSPEITOS;
+    c->ordemPistas  = casoEstaticoOrdemPistas;
+}
+#endif
+
+/* =============================== main ============================== */
+/* DQ_SEM_MAIN permite incluir este arquivo em outro programa (benchmark). */
+#ifndef DQ_SEM_MAIN
+int main(int argc, char **argv) {
+    const char *arquivoCaso = NULL, *arquivoExportar = NULL, *arquivoRoteiros = NULL;
+    int numThreads = 1, resolver = 0, compacto = 0, comDicas = 0, comViagem = 0;
+    const char *specMansao = NULL, *specGrafo = NULL;
+    iniciarSaida();
+    iniciarEntrada();
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--caso") == 0 && i + 1 < argc) {
+            arquivoCaso = argv[++i];
+        } else if (strcmp(argv[i], "--exportar-caso") == 0 && i + 1 < argc) {
+            arquivoExportar = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            arquivoRoteiros = argv[++i];
+        } else if (strcmp(argv[i], "--gerar") == 0 && i + 1 < argc) {
+            specMansao = argv[++i];
+        } else if (strcmp(argv[i], "--grafo") == 0 && i + 1 < argc) {
+            specGrafo = argv[++i];
+        } else if (strcmp(argv[i], "--resolver") == 0) {
+            resolver = 1;
+        } else if (strcmp(argv[i], "--compacto") == 0) {
+            compacto = 1;
+        } else if (strcmp(argv[i], "--dicas") == 0) {
+            comDicas = 1;
+        } else if (strcmp(argv[i], "--viagem") == 0) {
+            comViagem = 1;
+        } else if (strcmp(argv[i], "--silencioso") == 0) {
+            silencioso = 1;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            estAtivar("detetiveMestre");
+        } else if (strcmp(argv[i], "--memoria") == 0) {
+            memAtivar("detetiveMestre");
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            numThreads = atoi(argv[++i]);
+            if (numThreads < 1) numThreads = 1;
+            if (numThreads > MAX_THREADS) numThreads = MAX_THREADS;
+        } else {
+            fprintf(stderr, "Uso: %s [--caso arquivo.dqc] [--exportar-caso arquivo.dqc]"
+                            " [--replay roteiros.txt|-] [--resolver] [--threads N] [--compacto] [--dicas] [--viagem] [--silencioso] [--stats] [--memoria]"
+                            " [--gerar forma:salas[:semente[:densidade[:suspeitos]]]] [--grafo extras[:semente]]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    uint32_t extrasGrafo = 0;
+    uint64_t sementeGrafo = 1;
+    if (specGrafo) {
+        if (lerParametrosGrafo(specGrafo, &extrasGrafo, &sementeGrafo) != 0) {
+            fprintf(stderr, "Erro: --grafo espera extras[:semente] (extras de 0 a 64).\n");
+            return EXIT_FAILURE;
+        }
+        if (arquivoExportar || resolver || arquivoRoteiros || comDicas) {
+            fprintf(stderr, "Erro: --grafo so vale para a exploracao interativa"
+                            " (sem --exportar-caso, --resolver, --replay ou --dicas).\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* 1) Monta o mapa fixo (ou gera um) e
+       2) cria a tabela hash e popula com pista -> suspeito.
+       Um caso do disco ou estático já traz as duas coisas prontas. */
+    CasoBinario caso;
+    memset(&caso, 0, sizeof(caso));
+    Arena arenaMapa = { NULL, NULL };     /* salas e nomes (vida do caso) */
+    Arena arenaSessao = { NULL, NULL };   /* pistas coletadas (uma exploração) */
+    MansaoGerada gerada = { NULL, NULL, 0 };
+    Sala *mapa = NULL;
+    HashTable *ht = NULL;
+    if (arquivoCaso) {
+        if (specMansao) {
+            fprintf(stderr, "Erro: use --caso ou --gerar, nao os dois.\n");
+            return EXIT_FAILURE;
+        }
+        if (abrirCaso(arquivoCaso, &caso) != 0) return EXIT_FAILURE;
+        casoOrdenarPistas(&caso);
+    } else if (specMansao) {
+        ParametrosMansao params;
+        if (lerParametrosMansao(specMansao, &params) != 0) {
+            fprintf(stderr, "Erro: --gerar espera forma:salas[:semente[:densidade[:suspeitos]]]"
+                            " (forma: balanceada, degenerada ou aleatoria).\n");
+            return EXIT_FAILURE;
+        }
+        ht = criarHash(params.suspeitos * PISTAS_POR_SUSPEITO * 2);
+        gerada = gerarMansao(&params, ht, numThreads);
+        mapa = gerada.raiz;
+        ordenarInternos();
+    } else {
+#ifdef DQ_CASO_ESTATICO
+        if (!arquivoExportar) abrirCasoEstatico(&caso);
+#endif
+        if (!caso.salas) {
+            mapa = montarMapa(&arenaMapa);
+            ht = criarHash(101);
+            popularMapaPistas(ht);
+            ordenarInternos(); /* posições alfabéticas prontas antes da 1a partida */
+        }
+    }
+
+    /* --compacto: joga, repete e resolve sobre a forma compacta; a árvore
+       de ponteiros e a internação não são mais necessárias. As dicas usam
+       o resumo por índice de sala, então --dicas também compacta; o grafo
+       de --grafo e os índices de --viagem são montados sobre os índices do
+       caso, então eles também. */
+    if ((compacto || comDicas || specGrafo || comViagem) && mapa && !arquivoExportar) {
+        compactarMansao(mapa, ht, &caso);
+        liberarHash(ht);
+        ht = NULL;
+        liberarInternos();
+        arenaLiberar(&arenaMapa);
+        liberarMansaoGerada(&gerada);
+        mapa = NULL;
+    }
+
+    ResumoSuspeitos resumo = { NULL, 0 };
+    if (comDicas && caso.salas) montarResumo(&caso, &resumo);
+    GrafoMansao grafo = { 0, NULL, NULL };
+    if (specGrafo) montarGrafo(&caso, extrasGrafo, sementeGrafo, &grafo);
+    Viagem viagem;
+    memset(&viagem, 0, sizeof(viagem));
+    if (comViagem && caso.salas && !arquivoExportar && !resolver && !arquivoRoteiros) montarViagem(&caso, &viagem);
+    const Viagem *comRotas = viagem.slots ? &viagem : NULL;
+
+    int status = 0;
+    if (arquivoExportar) {
+        int r = mapa ? exportarCaso(mapa, ht, arquivoExportar) : -1;
+        if (!mapa) fprintf(stderr, "Erro: --exportar-caso usa a mansao embutida ou gerada.\n");
+        status = (r == 0) ? 0 : EXIT_FAILURE;
+    } else if (resolver) {
+        resolverMansao(mapa, ht, &caso, numThreads, stdout);
+    } else if (arquivoRoteiros) {
+        FILE *in = strcmp(arquivoRoteiros, "-") == 0 ? stdin : fopen(arquivoRoteiros, "r");
+        if (!in) {
+            perror(arquivoRoteiros);
+            status = EXIT_FAILURE;
+        } else {
+            Tabuleiro t = { &caso, mapa, ht };
+#ifndef _WIN32
+            if (numThreads > 1) executarRoteirosParalelo(in, stdout, &t, numThreads);
+            else
+#endif
+            executarRoteiros(in, stdout, &t);
+            fflush(stdout);
+            if (in != stdin) fclose(in);
+        }
+    } else {
+        /* 3) Loop simples de menu */
+        while (1) {
+            textoMenu("\n===== Menu =====\n");
+            textoMenu("1 - Explorar mansao e coletar pistas\n");
+            textoMenu("0 - Sair\n");
+            textoMenu("Opcao: ");
+
+            char linha[32];
+            fflush(stdout);
+            if (!estLerLinha(linha, sizeof(linha), stdin)) break;
+            int opcao = atoi(linha);
+
+            if (opcao == 1) {
+                /* BST e contadores iniciam vazios a cada exploração */
+                Evidencias ev;
+                iniciarEvidencias(&arenaSessao, &ev, caso.salas ? caso.numSuspeitos : internos.quantidade);
+
+                if (grafo.inicio)    explorarGrafo(&arenaSessao, &caso, &grafo, &ev, comRotas);
+                else if (caso.salas) explorarCaso(&arenaSessao, &caso, &ev, comDicas ? &resumo : NULL, comRotas);
+                else                 explorarSalas(&arenaSessao, mapa, &ev, ht);
+                verificarSuspeitoFinal(&ev, &caso);
+
+                arenaReiniciar(&arenaSessao); /* descarta a BST inteira em O(1) */
+            } else if (opcao == 0) {
+                break;
+            } else {
+                printf("Opcao invalida.\n");
+            }
+        }
+        printf("Programa encerrado. Ate a proxima!\n");
+    }
+
+    liberarResumo(&resumo);
+    liberarGrafo(&grafo);
+    liberarViagem(&viagem);
+    liberarHash(ht);
+    liberarInternos();
+    arenaLiberar(&arenaSessao);
+    arenaLiberar(&arenaMapa);
+    liberarMansaoGerada(&gerada);
+    fecharCaso(&caso);
+    fflush(stdout);
+    estEncerrar();
+    memEncerrar();
+    return status;
+}
+#endif /* DQ_SEM_MAIN */
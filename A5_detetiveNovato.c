@@ -1,92 +1,55 @@
+#define _POSIX_C_SOURCE 200809L  /* sigaction (A5_estatisticas.h) */
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+
+#include "A5_detetiveCore.h"   /* salas só com nome: nenhuma DQ_PISTAS_* */
 
 /* ============================================================
    Detective Quest - Mapa da Mansão (Árvore Binária)
    ------------------------------------------------------------
    Requisitos atendidos:
-   - Árvore binária com alocação dinâmica (struct Sala).
+   - Árvore binária com alocação dinâmica (struct Sala), em arena:
+     o mapa inteiro é liberado de uma vez.
    - Exploração interativa a partir do Hall (e/d/s).
    - Mansão montada automaticamente na main() via criarSala().
    - Exibe cada sala visitada e encerra ao chegar em um nó-folha
      ou quando o jogador escolher sair.
    - Código organizado, legível e comentado.
+   - Arena, salas, entrada, saída e exportação vêm do núcleo comum
+     (A5_detetiveCore.h), sem nada de pistas.
+   - Caso externo em formato binário (A5_casoBinario.h):
+       --caso arquivo.dqc           joga o caso mapeado do disco
+       --exportar-caso arquivo.dqc  grava a mansão embutida e sai
+   - Saída bufferizada, descarregada só antes de cada leitura;
+     --silencioso omite menus, caminhos e prompts.
+   - --stats (com -DDQ_ESTATISTICAS, A5_estatisticas.h): tempo por
+     jogada e bytes de salas/nomes, em JSON no stderr ao sair.
+   - --memoria (com -DDQ_MEMORIA, A5_memoria.h): bytes por
+     subsistema, pico e folga; vazamentos sempre acusados ao sair.
    ============================================================ */
 
-typedef struct Sala {
-    char *nome;               // nome da sala (string dinâmica)
-    struct Sala *esq;         // caminho à esquerda
-    struct Sala *dir;         // caminho à direita
-} Sala;
-
-/* ----------------- Utilidades de string ----------------- */
-/* strdup é POSIX; para portabilidade, implementamos nossa própria */
-static char *duplicaString(const char *s) {
-    size_t n = strlen(s) + 1;
-    char *copia = (char *)malloc(n);
-    if (!copia) return NULL;
-    memcpy(copia, s, n);
-    return copia;
-}
-
-/* ----------------- Criação e destruição ----------------- */
-/* criarSala() – cria, de forma dinâmica, uma sala com nome. */
-Sala *criarSala(const char *nome) {
-    Sala *nova = (Sala *)malloc(sizeof(Sala));
-    if (!nova) {
-        fprintf(stderr, "Erro: falha ao alocar memoria para sala \"%s\".\n", nome);
-        exit(EXIT_FAILURE);
-    }
-    nova->nome = duplicaString(nome);
-    if (!nova->nome) {
-        fprintf(stderr, "Erro: falha ao alocar memoria para nome da sala.\n");
-        free(nova);
-        exit(EXIT_FAILURE);
-    }
-    nova->esq = nova->dir = NULL;
-    return nova;
-}
-
-/* liberarArvore() – libera toda a árvore (pós-ordem). */
-void liberarArvore(Sala *raiz) {
-    if (!raiz) return;
-    liberarArvore(raiz->esq);
-    liberarArvore(raiz->dir);
-    free(raiz->nome);
-    free(raiz);
-}
-
 /* ----------------- Visual e interação ----------------- */
 static void cabecalho() {
-    printf("\n==============================================\n");
-    printf("        Detective Quest - Mansao Enigma        \n");
-    printf("==============================================\n");
+    textoMenu("\n==============================================\n");
+    textoMenu("        Detective Quest - Mansao Enigma        \n");
+    textoMenu("==============================================\n");
 }
 
 /* Mostra as opções contextuais com base nos caminhos disponíveis */
 static void mostrarOpcoes(const Sala *atual) {
     printf("\nVoce esta em: %s\n", atual->nome);
-    printf("Caminhos disponiveis:\n");
-    if (atual->esq)  printf("  (e) Esquerda: %s\n", atual->esq->nome);
-    if (atual->dir)  printf("  (d) Direita : %s\n", atual->dir->nome);
+    textoMenu("Caminhos disponiveis:\n");
+    if (atual->esq)  textoMenu("  (e) Esquerda: %s\n", atual->esq->nome);
+    if (atual->dir)  textoMenu("  (d) Direita : %s\n", atual->dir->nome);
     if (!atual->esq && !atual->dir)
-        printf("  Nenhum. (fim de caminho)\n");
-    printf("  (s) Sair da exploracao\n");
-    printf("Escolha [e/d/s]: ");
-}
-
-/* Ler a primeira letra não-espaco da linha e normalizar para minúsculo */
-static char lerOpcao() {
-    char linha[64];
-    if (!fgets(linha, sizeof(linha), stdin)) return 's'; // em caso de EOF, sair
-    for (size_t i = 0; linha[i]; ++i) {
-        if (!isspace((unsigned char)linha[i])) {
-            return (char)tolower((unsigned char)linha[i]);
-        }
-    }
-    return 's';
+        textoMenu("  Nenhum. (fim de caminho)\n");
+    textoMenu("  (s) Sair da exploracao\n");
+    textoMenu("Escolha [e/d/s]: ");
 }
 
 /* explorarSalas() – permite a navegação do jogador pela árvore.
@@ -139,6 +102,7 @@ void explorarSalas(Sala *raiz) {
             printf("Opcao invalida. Use 'e', 'd' ou 's'.\n");
         }
     }
+    descartarComandos();
 
     /* Exibe o trajeto completo percorrido */
     printf("\n---------- Salas visitadas ----------\n");
@@ -148,6 +112,56 @@ void explorarSalas(Sala *raiz) {
     printf("-------------------------------------\n");
 }
 
+/* explorarCaso() – mesma navegação de explorarSalas(), mas direto sobre
+   o caso binário mapeado (índices de sala em vez de ponteiros). */
+void explorarCaso(const CasoBinario *c) {
+    const int MAX_TRAJETO = 128;
+    uint32_t trajeto[128];
+    int passos = 0;
+
+    uint32_t atual = 0; /* sala 0 = Hall */
+    cabecalho();
+    printf("Bem-vindo(a)! Iniciando no Hall de entrada.\n");
+
+    while (1) {
+        if (passos < MAX_TRAJETO) trajeto[passos++] = atual;
+
+        uint32_t esq = casoEsq(c, atual), dir = casoDir(c, atual);
+        if (esq == CASO_NENHUM && dir == CASO_NENHUM) {
+            printf("\nVoce chegou ao fim do caminho em: %s\n", casoNomeSala(c, atual));
+            break;
+        }
+
+        printf("\nVoce esta em: %s\n", casoNomeSala(c, atual));
+        textoMenu("Caminhos disponiveis:\n");
+        if (esq != CASO_NENHUM) textoMenu("  (e) Esquerda: %s\n", casoNomeSala(c, esq));
+        if (dir != CASO_NENHUM) textoMenu("  (d) Direita : %s\n", casoNomeSala(c, dir));
+        textoMenu("  (s) Sair da exploracao\n");
+        textoMenu("Escolha [e/d/s]: ");
+        char op = lerOpcao();
+
+        if (op == 's') {
+            printf("\nExploracao encerrada pelo jogador.\n");
+            break;
+        } else if (op == 'e') {
+            if (esq != CASO_NENHUM) atual = esq;
+            else printf("Nao ha caminho a esquerda a partir de %s.\n", casoNomeSala(c, atual));
+        } else if (op == 'd') {
+            if (dir != CASO_NENHUM) atual = dir;
+            else printf("Nao ha caminho a direita a partir de %s.\n", casoNomeSala(c, atual));
+        } else {
+            printf("Opcao invalida. Use 'e', 'd' ou 's'.\n");
+        }
+    }
+    descartarComandos();
+
+    printf("\n---------- Salas visitadas ----------\n");
+    for (int i = 0; i < passos; ++i) {
+        printf("%s%s", casoNomeSala(c, trajeto[i]), (i + 1 < passos ? " -> " : "\n"));
+    }
+    printf("-------------------------------------\n");
+}
+
 /* ----------------- Montagem do mapa ----------------- */
 /*
    Mapa proposto (exemplo):
@@ -162,18 +176,18 @@ void explorarSalas(Sala *raiz) {
 
   - Vários nós-folha para ilustrar finais de caminho.
 */
-Sala *montarMapa() {
-    Sala *hall        = criarSala("Hall de entrada");
-    Sala *estar       = criarSala("Sala de Estar");
-    Sala *corredor    = criarSala("Corredor");
-    Sala *biblio      = criarSala("Biblioteca");
-    Sala *cozinha     = criarSala("Cozinha");
-    Sala *escritorio  = criarSala("Escritorio");
-    Sala *jardim      = criarSala("Jardim");
-    Sala *adega       = criarSala("Adega");
-    Sala *deposito    = criarSala("Deposito");
-    Sala *despensa    = criarSala("Despensa");
-    Sala *estufa      = criarSala("Estufa");
+Sala *montarMapa(Arena *a) {
+    Sala *hall        = criarSala(a, "Hall de entrada");
+    Sala *estar       = criarSala(a, "Sala de Estar");
+    Sala *corredor    = criarSala(a, "Corredor");
+    Sala *biblio      = criarSala(a, "Biblioteca");
+    Sala *cozinha     = criarSala(a, "Cozinha");
+    Sala *escritorio  = criarSala(a, "Escritorio");
+    Sala *jardim      = criarSala(a, "Jardim");
+    Sala *adega       = criarSala(a, "Adega");
+    Sala *deposito    = criarSala(a, "Deposito");
+    Sala *despensa    = criarSala(a, "Despensa");
+    Sala *estufa      = criarSala(a, "Estufa");
 
     /* ligações */
     hall->esq = estar;
@@ -197,22 +211,62 @@ Sala *montarMapa() {
 
 /* ----------------- main() ----------------- */
 /* main() – monta o mapa inicial e dá início à exploração. */
-int main(void) {
-    Sala *raiz = montarMapa();
+int main(int argc, char **argv) {
+    const char *arquivoCaso = NULL, *arquivoExportar = NULL;
+    iniciarSaida();
+    iniciarEntrada();
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--caso") == 0 && i + 1 < argc) {
+            arquivoCaso = argv[++i];
+        } else if (strcmp(argv[i], "--exportar-caso") == 0 && i + 1 < argc) {
+            arquivoExportar = argv[++i];
+        } else if (strcmp(argv[i], "--silencioso") == 0) {
+            silencioso = 1;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            estAtivar("detetiveNovato");
+        } else if (strcmp(argv[i], "--memoria") == 0) {
+            memAtivar("detetiveNovato");
+        } else {
+            fprintf(stderr, "Uso: %s [--caso arquivo.dqc] [--exportar-caso arquivo.dqc] [--silencioso] [--stats] [--memoria]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    CasoBinario caso;
+    memset(&caso, 0, sizeof(caso));
+    Arena arenaMapa = { NULL, NULL };
+    Sala *raiz = NULL;
+    if (arquivoCaso) {
+        if (abrirCaso(arquivoCaso, &caso) != 0) return EXIT_FAILURE;
+    } else {
+        raiz = montarMapa(&arenaMapa);
+    }
+
+    if (arquivoExportar) {
+        int r = raiz ? exportarCaso(raiz, arquivoExportar) : -1;
+        if (!raiz) fprintf(stderr, "Erro: --exportar-caso usa a mansao embutida.\n");
+        arenaLiberar(&arenaMapa);
+        fecharCaso(&caso);
+        estEncerrar();
+        memEncerrar();
+        return r == 0 ? 0 : EXIT_FAILURE;
+    }
 
     /* Loop simples com menu para começar ou sair (novato-friendly) */
     while (1) {
-        printf("\n===== Menu =====\n");
-        printf("1 - Explorar a mansao\n");
-        printf("0 - Sair\n");
-        printf("Opcao: ");
+        textoMenu("\n===== Menu =====\n");
+        textoMenu("1 - Explorar a mansao\n");
+        textoMenu("0 - Sair\n");
+        textoMenu("Opcao: ");
 
         char linha[32];
-        if (!fgets(linha, sizeof(linha), stdin)) break;
+        fflush(stdout);
+        if (!estLerLinha(linha, sizeof(linha), stdin)) break;
         int opcao = atoi(linha);
 
         if (opcao == 1) {
-            explorarSalas(raiz);
+            if (caso.salas) explorarCaso(&caso);
+            else            explorarSalas(raiz);
         } else if (opcao == 0) {
             break;
         } else {
@@ -220,7 +274,11 @@ int main(void) {
         }
     }
 
-    liberarArvore(raiz);
+    arenaLiberar(&arenaMapa);
+    fecharCaso(&caso);
     printf("Programa encerrado. Ate a proxima!\n");
+    fflush(stdout);
+    estEncerrar();
+    memEncerrar();
     return 0;
 }
\ No newline at end of file
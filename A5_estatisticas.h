@@ -0,0 +1,264 @@
+#ifndef A5_ESTATISTICAS_H
+#define A5_ESTATISTICAS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include <string.h>
+#include <signal.h>
+#include <errno.h>
+
+/* ============================================================
+   Detective Quest - Instrumentação dos caminhos quentes
+   ------------------------------------------------------------
+   Contadores e tempos compartilhados pelos três capítulos,
+   compilados só com -DDQ_ESTATISTICAS: sem a macro, todo EST_*
+   vira ((void)0) e nem as tabelas nem as chamadas de relógio
+   existem no binário.
+
+   Cada medida guarda quantidade, soma, máximo e um histograma em
+   potências de 2 (balde k: valores com k bits), de onde saem
+   percentis aproximados (limite superior do balde). Medidas de
+   cada capítulo (as que ele não tem ficam com n = 0):
+
+     sondagensInterno    slots lidos por consulta na internação
+                         (encontrarSuspeito, internar) – Mestre
+     profundidadePista   nível onde inserirPista parou (raiz = 0)
+     comparacoesPista    comparações de chave por inserirPista
+     strcmpPistaDaSala   strcmp por chamada de pistaDaSala
+     bytesDuplicaString  bytes por arenaDuplicaString (n = cópias)
+     bytesCriarSala      bytes do nó por criarSala
+     bytesCriarHash      bytes reservados por criarHash
+     nsPorJogada         da leitura de um comando até o próximo
+                         prompt (sem a espera pelo jogador)
+
+   --stats liga o despejo: JSON no stderr ao sair e, em POSIX, a
+   cada SIGUSR1 (na hora, se o jogo espera o jogador; senão, na
+   próxima leitura ou prompt; um pedido ainda pendente sai junto com
+   o despejo final). O tratador é instalado com sigaction sem
+   SA_RESTART, para a leitura bloqueada voltar com EINTR: toda leitura
+   de stdin passa por estLerLinha() ou estLerBloco(), que atendem o
+   pedido e voltam a ler. Quem inclui este arquivo compila com
+   _POSIX_C_SOURCE (sigaction). Sem -DDQ_ESTATISTICAS, --stats só avisa
+   que não há o que medir.
+
+   Threads de --threads (roteiros, resolvedor, gerador) medem na própria
+   tabela e a entregam ao terminar (EST_ENTREGAR_THREAD); o despejo soma
+   a thread principal e as entregues, e diz quantas foram ("threads").
+   ============================================================ */
+
+#ifdef DQ_ESTATISTICAS
+
+#include <stdatomic.h>
+
+#define EST_BALDES 65
+
+typedef struct MedidaEst {
+    uint64_t n, soma, max;
+    uint64_t baldes[EST_BALDES];   /* baldes[k]: valores com k bits (0 -> balde 0) */
+} MedidaEst;
+
+#define EST_MEDIDAS(X) \
+    X(sondagensInterno)    \
+    X(profundidadePista)   \
+    X(comparacoesPista)    \
+    X(strcmpPistaDaSala)   \
+    X(bytesDuplicaString)  \
+    X(bytesCriarSala)      \
+    X(bytesCriarHash)      \
+    X(nsPorJogada)
+
+typedef enum {
+#define EST_ENUM(nome) EST_##nome,
+    EST_MEDIDAS(EST_ENUM)
+#undef EST_ENUM
+    EST_NUM_MEDIDAS
+} IdMedidaEst;
+
+static const char *const NOMES_MEDIDAS_EST[EST_NUM_MEDIDAS] = {
+#define EST_NOME(nome) #nome,
+    EST_MEDIDAS(EST_NOME)
+#undef EST_NOME
+};
+
+/* por thread, sem corrida no caminho quente; ver estEntregarThread() */
+static _Thread_local MedidaEst estMedidas[EST_NUM_MEDIDAS];
+static MedidaEst estEntregues[EST_NUM_MEDIDAS];   /* soma das threads que terminaram */
+static unsigned estNumEntregues = 0;
+static atomic_flag estTrava = ATOMIC_FLAG_INIT;
+static const char *estPrograma = NULL;     /* NULL = --stats desligado */
+static uint64_t estInicioJogada = 0;       /* 0 = nenhuma jogada aberta */
+static volatile sig_atomic_t estPedido = 0;
+
+static inline void estRegistrar(IdMedidaEst id, uint64_t v) {
+    MedidaEst *m = &estMedidas[id];
+    unsigned bits = 0;
+    for (uint64_t x = v; x; x >>= 1) ++bits;
+    m->n++;
+    m->soma += v;
+    if (v > m->max) m->max = v;
+    m->baldes[bits]++;
+}
+
+static inline uint64_t estAgoraNs(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* percentil aproximado: maior valor possível do balde onde ele cai */
+static inline uint64_t estPercentil(const MedidaEst *m, double p) {
+    uint64_t alvo = (uint64_t)(p / 100.0 * (double)m->n + 0.999999), acumulado = 0;
+    for (unsigned k = 0; k < EST_BALDES; ++k) {
+        acumulado += m->baldes[k];
+        if (acumulado >= alvo && m->baldes[k]) {
+            uint64_t teto = k == 0 ? 0 : k == 64 ? UINT64_MAX : (((uint64_t)1 << k) - 1);
+            return teto < m->max ? teto : m->max;
+        }
+    }
+    return m->max;
+}
+
+static inline void estSomar(MedidaEst *destino, const MedidaEst *m) {
+    destino->n += m->n;
+    destino->soma += m->soma;
+    if (m->max > destino->max) destino->max = m->max;
+    for (unsigned k = 0; k < EST_BALDES; ++k) destino->baldes[k] += m->baldes[k];
+}
+
+static inline void estTravar(void) {
+    while (atomic_flag_test_and_set_explicit(&estTrava, memory_order_acquire)) {}
+}
+
+static inline void estDestravar(void) {
+    atomic_flag_clear_explicit(&estTrava, memory_order_release);
+}
+
+/* estEntregarThread() – fim de uma thread de trabalho: soma a tabela dela
+   às entregues e a zera (a main, que também trabalha, não conta duas vezes). */
+static inline void estEntregarThread(void) {
+    estTravar();
+    for (int i = 0; i < EST_NUM_MEDIDAS; ++i) estSomar(&estEntregues[i], &estMedidas[i]);
+    ++estNumEntregues;
+    estDestravar();
+    memset(estMedidas, 0, sizeof(estMedidas));
+}
+
+static inline void estDespejar(const char *momento) {
+    MedidaEst total[EST_NUM_MEDIDAS];
+    unsigned threads;
+    estTravar();
+    memcpy(total, estEntregues, sizeof(total));
+    threads = estNumEntregues;
+    estDestravar();
+    for (int i = 0; i < EST_NUM_MEDIDAS; ++i) estSomar(&total[i], &estMedidas[i]);
+
+    fprintf(stderr, "{\"programa\": \"%s\", \"momento\": \"%s\", \"threads\": %u, \"medidas\": {",
+            estPrograma ? estPrograma : "?", momento, threads);
+    for (int i = 0; i < EST_NUM_MEDIDAS; ++i) {
+        const MedidaEst *m = &total[i];
+        fprintf(stderr, "%s\n  \"%s\": {\"n\": %llu, \"soma\": %llu, \"media\": %.3f, \"max\": %llu,"
+                        " \"p50\": %llu, \"p90\": %llu, \"p99\": %llu}",
+                i ? "," : "", NOMES_MEDIDAS_EST[i], (unsigned long long)m->n, (unsigned long long)m->soma,
+                m->n ? (double)m->soma / (double)m->n : 0.0, (unsigned long long)m->max,
+                (unsigned long long)estPercentil(m, 50), (unsigned long long)estPercentil(m, 90),
+                (unsigned long long)estPercentil(m, 99));
+    }
+    fprintf(stderr, "\n}}\n");
+    fflush(stderr);
+}
+
+#ifndef _WIN32
+static void estAoSinal(int sinal) {
+    (void)sinal;
+    estPedido = 1;
+}
+#endif
+
+/* estAtivar() – --stats: despeja ao sair (estEncerrar) e sob SIGUSR1. */
+static inline void estAtivar(const char *programa) {
+    estPrograma = programa;
+#ifndef _WIN32
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = estAoSinal;
+    sa.sa_flags = 0;             /* sem SA_RESTART: a leitura bloqueada volta com EINTR */
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGUSR1, &sa, NULL);
+#endif
+}
+
+/* Pedido pendente: despeja agora. */
+static inline void estAtenderPedido(void) {
+    if (estPedido && estPrograma) estDespejar("sinal");
+    estPedido = 0;
+}
+
+static inline void estEncerrar(void) {
+    estAtenderPedido();
+    if (estPrograma) estDespejar("saida");
+}
+
+/* estLerLinha() – fgets de stdin: atende um pedido pendente antes de
+   bloquear; um SIGUSR1 durante a espera faz o fgets voltar com EINTR,
+   e o pedido é atendido na hora, sem confundir a interrupção com EOF. */
+static inline char *estLerLinha(char *s, int n, FILE *f) {
+    for (;;) {
+        estAtenderPedido();
+        errno = 0;
+        char *r = fgets(s, n, f);
+        if (r || errno != EINTR || !ferror(f)) return r;
+        clearerr(f);
+    }
+}
+
+/* estLerBloco() – fread com o mesmo cuidado (roteiros lidos de stdin). */
+static inline size_t estLerBloco(void *p, size_t n, FILE *f) {
+    for (;;) {
+        estAtenderPedido();
+        errno = 0;
+        size_t r = fread(p, 1, n, f);
+        if (r == n || errno != EINTR || !ferror(f)) return r;
+        clearerr(f);
+        if (r) return r;
+    }
+}
+
+#define EST_REGISTRAR(medida, valor) estRegistrar(EST_##medida, (uint64_t)(valor))
+/* contador local que só existe instrumentado: EST_LOCAL(c); ... EST_INC(c); */
+#define EST_LOCAL(nome)              uint64_t nome = 0
+#define EST_INC(nome)                (++(nome))
+/* jogada: aberta quando o comando sai da fila, fechada no próximo prompt
+   já entregue (ou no fim da exploração) */
+#define EST_ABRIR_JOGADA() (estInicioJogada = estAgoraNs())
+#define EST_FECHAR_JOGADA() \
+    do { \
+        if (estInicioJogada) EST_REGISTRAR(nsPorJogada, estAgoraNs() - estInicioJogada); \
+        estInicioJogada = 0; \
+    } while (0)
+#define EST_ATENDER_PEDIDO()         estAtenderPedido()
+#define EST_ENTREGAR_THREAD()        estEntregarThread()
+
+#else /* !DQ_ESTATISTICAS */
+
+static inline void estAtivar(const char *programa) {
+    (void)programa;
+    fprintf(stderr, "--stats: compilado sem -DDQ_ESTATISTICAS, nada a medir.\n");
+}
+
+static inline void estEncerrar(void) {}
+
+static inline char *estLerLinha(char *s, int n, FILE *f) { return fgets(s, n, f); }
+static inline size_t estLerBloco(void *p, size_t n, FILE *f) { return fread(p, 1, n, f); }
+
+#define EST_REGISTRAR(medida, valor) ((void)0)
+#define EST_LOCAL(nome)
+#define EST_INC(nome)                ((void)0)
+#define EST_ABRIR_JOGADA()           ((void)0)
+#define EST_FECHAR_JOGADA()          ((void)0)
+#define EST_ATENDER_PEDIDO()         ((void)0)
+#define EST_ENTREGAR_THREAD()        ((void)0)
+
+#endif /* DQ_ESTATISTICAS */
+
+#endif /* A5_ESTATISTICAS_H */
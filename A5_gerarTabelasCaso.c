@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "A5_casoBinario.h"
+
+/* ============================================================
+   Detective Quest - Gerador de Tabelas Estáticas
+   ------------------------------------------------------------
+   Lê um caso binário (.dqc) e escreve, na saída padrão, um
+   cabeçalho C com as mesmas tabelas em arrays "static const":
+   salas, pistas (e sua ordem alfabética), suspeitos e o bloco
+   de textos. Compilado com -DDQ_CASO_ESTATICO, o capítulo
+   Mestre usa essas tabelas direto do binário, sem montar nada
+   em tempo de execução.
+
+   Uso: gerarTabelasCaso caso.dqc [GUARDA] > A5_casoMansao.h
+   ============================================================ */
+
+/* Escreve um texto como literal C; bytes fora do ASCII imprimível
+   viram escapes octais de 3 dígitos (não se fundem ao próximo char). */
+static void escreverLiteral(FILE *out, const char *s) {
+    fputc('"', out);
+    for (const unsigned char *p = (const unsigned char *)s; *p; ++p) {
+        if (*p == '"' || *p == '\\') fprintf(out, "\\%c", *p);
+        else if (*p < 0x20 || *p >= 0x7F) fprintf(out, "\\%03o", *p);
+        else fputc(*p, out);
+    }
+    fputs("\\0\"", out);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "Uso: %s caso.dqc [GUARDA] > cabecalho.h\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    const char *guarda = (argc == 3) ? argv[2] : "A5_CASO_MANSAO_H";
+
+    CasoBinario c;
+    if (abrirCaso(argv[1], &c) != 0) return EXIT_FAILURE;
+    FILE *out = stdout;
+
+    fprintf(out, "/* Gerado por A5_gerarTabelasCaso.c a partir de \"%s\" - nao editar. */\n", argv[1]);
+    fprintf(out, "#ifndef %s\n#define %s\n\n", guarda, guarda);
+    fprintf(out, "#include \"A5_casoBinario.h\"\n\n");
+    fprintf(out, "#define CASO_ESTATICO_NUM_SALAS     %uu\n", c.numSalas);
+    fprintf(out, "#define CASO_ESTATICO_NUM_PISTAS    %uu\n", c.numPistas);
+    fprintf(out, "#define CASO_ESTATICO_NUM_SUSPEITOS %uu\n\n", c.numSuspeitos);
+
+    /* salas: { nome, pista, esq, dir } – comentário com o nome para leitura */
+    fprintf(out, "static const CasoSala casoEstaticoSalas[%u] = {\n", c.numSalas);
+    for (uint32_t i = 0; i < c.numSalas; ++i) {
+        const CasoSala *s = &c.salas[i];
+        fprintf(out, "    { %uu, 0x%Xu, 0x%Xu, 0x%Xu }, /* %u: %s */\n",
+                s->nome, s->pista, s->esq, s->dir, i, casoNomeSala(&c, i));
+    }
+    fprintf(out, "};\n\n");
+
+    /* C não aceita arrays vazios: uma entrada fictícia é ignorada pelo contador. */
+    fprintf(out, "static const CasoPista casoEstaticoPistas[%u] = {\n", c.numPistas ? c.numPistas : 1);
+    for (uint32_t i = 0; i < c.numPistas; ++i) {
+        fprintf(out, "    { %uu, 0x%Xu }, /* %u: %s */\n",
+                c.pistas[i].texto, c.pistas[i].suspeito, i, casoTexto(&c, c.pistas[i].texto));
+    }
+    if (!c.numPistas) fprintf(out, "    { 0u, 0x%Xu }\n", CASO_NENHUM);
+    fprintf(out, "};\n\n");
+
+    /* posição alfabética de cada pista (ordem da árvore de pistas) */
+    casoOrdenarPistas(&c);
+    fprintf(out, "static const uint32_t casoEstaticoOrdemPistas[%u] = {\n   ", c.numPistas ? c.numPistas : 1);
+    for (uint32_t i = 0; i < c.numPistas; ++i) fprintf(out, " %uu,", c.ordemPistas[i]);
+    if (!c.numPistas) fprintf(out, " 0u");
+    fprintf(out, "\n};\n\n");
+
+    fprintf(out, "static const uint32_t casoEstaticoSuspeitos[%u] = {\n", c.numSuspeitos ? c.numSuspeitos : 1);
+    for (uint32_t i = 0; i < c.numSuspeitos; ++i) {
+        fprintf(out, "    %uu, /* %u: %s */\n", c.suspeitos[i], i, casoTexto(&c, c.suspeitos[i]));
+    }
+    if (!c.numSuspeitos) fprintf(out, "    0u\n");
+    fprintf(out, "};\n\n");
+
+    /* bloco de textos: um literal por string, na ordem dos deslocamentos */
+    fprintf(out, "static const char casoEstaticoTextos[] =\n");
+    for (uint64_t off = 0; off < c.tamTextos;) {
+        const char *s = c.textos + off;
+        fputs("    ", out);
+        escreverLiteral(out, s);
+        fputc('\n', out);
+        off += strlen(s) + 1;
+    }
+    fprintf(out, "    ;\n\n#endif /* %s */\n", guarda);
+
+    fecharCaso(&c);
+    return 0;
+}
@@ -0,0 +1,281 @@
+#ifndef A5_MEMORIA_H
+#define A5_MEMORIA_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* ============================================================
+   Detective Quest - Contabilidade de memória por subsistema
+   ------------------------------------------------------------
+   Todo malloc/calloc/realloc/free dos três capítulos (e do caso
+   binário) passa por memAlocar/memZerada/memRealocar/memLiberar,
+   com uma etiqueta do subsistema dono do bloco. Os blocos das
+   arenas são etiquetados como "arena"; o que se pede a uma arena
+   é contado, à parte, na etiqueta do objeto (sala, nome, pista...).
+
+   Só com -DDQ_MEMORIA há contabilidade: cada bloco ganha um
+   cabeçalho com tamanho e etiqueta, e cada etiqueta acumula bytes
+   e alocações vivas, pico e total. Sem a macro, as funções são o
+   malloc/free de sempre e as arenas não guardam contadores.
+
+   Ao sair, um binário com DQ_MEMORIA sempre acusa no stderr o que
+   ficou sem liberar; --memoria imprime também a tabela completa e
+   a folga: memória física estimada (blocos do malloc arredondados
+   como no glibc, arenas inteiras) contra o layout compacto (cada
+   objeto com o tamanho exato, sem padding nem sobra de bloco).
+   ============================================================ */
+
+#define MEM_ETIQUETAS(X)                          \
+    X(SALAS,     "salas",     "nos de sala")      \
+    X(NOMES,     "nomes",     "nomes de sala")    \
+    X(PISTAS,    "pistas",    "nos de pista")     \
+    X(BALDES,    "baldes",    "baldes de hash")   \
+    X(ENTRADAS,  "entradas",  "entradas de hash") \
+    X(TEXTOS,    "textos",    "strings")          \
+    X(CASO,      "caso",      "caso binario")     \
+    X(TRABALHO,  "trabalho",  "vetores de apoio") \
+    X(ARENA,     "arena",     "blocos de arena")
+
+typedef enum {
+#define MEM_ENUM(id, curto, descricao) MEM_##id,
+    MEM_ETIQUETAS(MEM_ENUM)
+#undef MEM_ENUM
+    MEM_NUM_ETIQUETAS
+} EtiquetaMem;
+
+#ifdef DQ_MEMORIA
+
+#include <stdatomic.h>
+
+/* Cabeçalho antes de cada bloco; o alinhamento mantém o ponteiro
+   devolvido tão alinhado quanto o do malloc. */
+typedef struct CabecalhoMem {
+    _Alignas(max_align_t) size_t tamanho;
+    uint32_t etiqueta;
+    uint32_t marca;             /* MEM_MARCA: detecta free de bloco alheio */
+    uint32_t recuo;             /* do início do bloco real até os dados */
+} CabecalhoMem;
+
+#define MEM_MARCA 0xD7C0FFEEu
+
+typedef struct ContaMem {
+    atomic_size_t bytes, pico, vivas, total;   /* bytes pedidos, exatos */
+    atomic_size_t fisico;       /* bytes vivos estimados no malloc */
+} ContaMem;
+
+/* contadores globais: as threads de --threads alocam em paralelo */
+static ContaMem memContas[MEM_NUM_ETIQUETAS];
+static atomic_size_t memFisicoTotal, memPicoFisico;     /* blocos do malloc */
+static atomic_size_t memCompactoTotal, memPicoCompacto; /* objetos, fora "arena" */
+static const char *memPrograma = NULL;   /* NULL = sem tabela ao sair */
+
+/* bloco de n bytes no malloc do glibc: 8 de cabeçalho, múltiplo de 16,
+   mínimo 32 (estimativa; o cabeçalho de MEM não entra) */
+static inline size_t memFisico(size_t n) {
+    size_t c = (n + 8 + 15) & ~(size_t)15;
+    return c < 32 ? 32 : c;
+}
+
+static inline void memAtualizarPico(atomic_size_t *pico, size_t valor) {
+    size_t atual = atomic_load_explicit(pico, memory_order_relaxed);
+    while (valor > atual &&
+           !atomic_compare_exchange_weak_explicit(pico, &atual, valor, memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+}
+
+/* memContar() – entra (sinal > 0) ou sai um objeto de n bytes da etiqueta.
+   fisico = 0 para objetos dentro de arenas (o bloco já foi contado). */
+static inline void memContar(EtiquetaMem e, size_t n, size_t fisico, int sinal) {
+    ContaMem *c = &memContas[e];
+    if (sinal > 0) {
+        size_t agora = atomic_fetch_add_explicit(&c->bytes, n, memory_order_relaxed) + n;
+        atomic_fetch_add_explicit(&c->vivas, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&c->total, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&c->fisico, fisico, memory_order_relaxed);
+        memAtualizarPico(&c->pico, agora);
+        if (fisico) {
+            size_t total = atomic_fetch_add_explicit(&memFisicoTotal, fisico, memory_order_relaxed) + fisico;
+            memAtualizarPico(&memPicoFisico, total);
+        }
+        if (e != MEM_ARENA) {
+            size_t total = atomic_fetch_add_explicit(&memCompactoTotal, n, memory_order_relaxed) + n;
+            memAtualizarPico(&memPicoCompacto, total);
+        }
+    } else {
+        atomic_fetch_sub_explicit(&c->bytes, n, memory_order_relaxed);
+        atomic_fetch_sub_explicit(&c->vivas, 1, memory_order_relaxed);
+        atomic_fetch_sub_explicit(&c->fisico, fisico, memory_order_relaxed);
+        if (fisico) atomic_fetch_sub_explicit(&memFisicoTotal, fisico, memory_order_relaxed);
+        if (e != MEM_ARENA) atomic_fetch_sub_explicit(&memCompactoTotal, n, memory_order_relaxed);
+    }
+}
+
+static inline void *memDoCabecalho(CabecalhoMem *h, EtiquetaMem e, size_t n) {
+    h->tamanho = n;
+    h->etiqueta = (uint32_t)e;
+    h->marca = MEM_MARCA;
+    h->recuo = sizeof(CabecalhoMem);
+    memContar(e, n, memFisico(n), +1);
+    return h + 1;
+}
+
+static inline CabecalhoMem *memCabecalho(void *p) {
+    CabecalhoMem *h = (CabecalhoMem *)p - 1;
+    if (h->marca != MEM_MARCA) {
+        fprintf(stderr, "Erro: memLiberar/memRealocar em bloco que nao veio de memAlocar (%p).\n", p);
+        abort();
+    }
+    return h;
+}
+
+static inline void *memAlocar(EtiquetaMem e, size_t n) {
+    CabecalhoMem *h = (CabecalhoMem *)malloc(sizeof(CabecalhoMem) + n);
+    return h ? memDoCabecalho(h, e, n) : NULL;
+}
+
+static inline void *memZerada(EtiquetaMem e, size_t quantidade, size_t tamanho) {
+    if (tamanho && quantidade > (SIZE_MAX - sizeof(CabecalhoMem)) / tamanho) return NULL;
+    CabecalhoMem *h = (CabecalhoMem *)calloc(1, sizeof(CabecalhoMem) + quantidade * tamanho);
+    return h ? memDoCabecalho(h, e, quantidade * tamanho) : NULL;
+}
+
+/* memAlinhada() – aligned_alloc etiquetado (alinhamento >= cabeçalho).
+   Blocos alinhados não podem ser realocados. */
+static inline void *memAlinhada(EtiquetaMem e, size_t alinhamento, size_t n) {
+    size_t recuo = alinhamento < sizeof(CabecalhoMem) ? sizeof(CabecalhoMem) : alinhamento;
+    size_t total = (recuo + n + alinhamento - 1) / alinhamento * alinhamento;
+    unsigned char *base = (unsigned char *)aligned_alloc(alinhamento, total);
+    if (!base) return NULL;
+    CabecalhoMem *h = (CabecalhoMem *)(base + recuo) - 1;
+    void *p = memDoCabecalho(h, e, n);
+    h->recuo = (uint32_t)recuo;
+    return p;
+}
+
+static inline void *memRealocar(EtiquetaMem e, void *p, size_t n) {
+    if (!p) return memAlocar(e, n);
+    CabecalhoMem *h = memCabecalho(p);
+    if (h->recuo != sizeof(CabecalhoMem)) {
+        fprintf(stderr, "Erro: memRealocar em bloco de memAlinhada (%p).\n", p);
+        abort();
+    }
+    size_t velho = h->tamanho;
+    EtiquetaMem ev = (EtiquetaMem)h->etiqueta;
+    CabecalhoMem *novo = (CabecalhoMem *)realloc(h, sizeof(CabecalhoMem) + n);
+    if (!novo) return NULL;      /* o bloco antigo continua válido e contado */
+    memContar(ev, velho, memFisico(velho), -1);
+    return memDoCabecalho(novo, e, n);
+}
+
+static inline void memLiberar(void *p) {
+    if (!p) return;
+    CabecalhoMem *h = memCabecalho(p);
+    memContar((EtiquetaMem)h->etiqueta, h->tamanho, memFisico(h->tamanho), -1);
+    h->marca = 0;
+    free((unsigned char *)p - h->recuo);
+}
+
+/* Arenas guardam o que contaram por etiqueta, para devolver tudo no
+   reinício ou na liberação. */
+typedef struct ContaArenaMem {
+    size_t bytes[MEM_NUM_ETIQUETAS];
+    size_t vivas[MEM_NUM_ETIQUETAS];
+} ContaArenaMem;
+
+static inline void memArenaContar(ContaArenaMem *a, EtiquetaMem e, size_t n) {
+    a->bytes[e] += n;
+    a->vivas[e]++;
+    memContar(e, n, 0, +1);
+}
+
+/* campo e ganchos usados pelas arenas dos capítulos: a conta mora no
+   primeiro bloco (sem bloco, nada foi contado) */
+#define MEM_ARENA_CAMPO               ContaArenaMem contaMem;
+#define MEM_ARENA_INICIAR(b)          memset(&(b)->contaMem, 0, sizeof((b)->contaMem))
+#define MEM_ARENA_CONTAR(a, e, n)     memArenaContar(&(a)->primeiro->contaMem, (e), (n))
+#define MEM_ARENA_DESCONTAR(a) \
+    do { if ((a)->primeiro) memArenaDescontar(&(a)->primeiro->contaMem); } while (0)
+
+static inline void memArenaDescontar(ContaArenaMem *a) {
+    for (int e = 0; e < MEM_NUM_ETIQUETAS; ++e) {
+        ContaMem *c = &memContas[e];
+        atomic_fetch_sub_explicit(&c->bytes, a->bytes[e], memory_order_relaxed);
+        atomic_fetch_sub_explicit(&c->vivas, a->vivas[e], memory_order_relaxed);
+        atomic_fetch_sub_explicit(&memCompactoTotal, a->bytes[e], memory_order_relaxed);
+        a->bytes[e] = a->vivas[e] = 0;
+    }
+}
+
+/* memAtivar() – --memoria: tabela completa ao sair. */
+static inline void memAtivar(const char *programa) {
+    memPrograma = programa;
+}
+
+/* memEncerrar() – chamado depois de liberar tudo: o que restar vivo é
+   vazamento (sempre relatado); a tabela só com --memoria. */
+static inline void memEncerrar(void) {
+    static const char *const curtos[] = {
+#define MEM_CURTO(id, curto, descricao) curto,
+        MEM_ETIQUETAS(MEM_CURTO)
+#undef MEM_CURTO
+    };
+    static const char *const descricoes[] = {
+#define MEM_DESCRICAO(id, curto, descricao) descricao,
+        MEM_ETIQUETAS(MEM_DESCRICAO)
+#undef MEM_DESCRICAO
+    };
+    if (memPrograma) {
+        fprintf(stderr, "memoria (%s)\n  %-9s %-17s %12s %12s %12s %9s %9s\n", memPrograma, "etiqueta",
+                "descricao", "vivos", "pico", "fisico", "vivas", "total");
+        for (int e = 0; e < MEM_NUM_ETIQUETAS; ++e) {
+            const ContaMem *c = &memContas[e];
+            fprintf(stderr, "  %-9s %-17s %12zu %12zu %12zu %9zu %9zu\n", curtos[e], descricoes[e],
+                    atomic_load(&c->bytes), atomic_load(&c->pico), atomic_load(&c->fisico),
+                    atomic_load(&c->vivas), atomic_load(&c->total));
+        }
+        /* folga nos picos: ao sair quase tudo já foi devolvido */
+        size_t fisico = atomic_load(&memPicoFisico), compacto = atomic_load(&memPicoCompacto);
+        double folga = (double)fisico - (double)compacto;
+        fprintf(stderr, "  pico fisico (estimado) %zu bytes, pico compacto %zu bytes: folga %.0f bytes (%.1f%%)\n",
+                fisico, compacto, folga, fisico ? 100.0 * folga / (double)fisico : 0.0);
+    }
+    for (int e = 0; e < MEM_NUM_ETIQUETAS; ++e) {
+        size_t vivas = atomic_load(&memContas[e].vivas);
+        if (vivas) {
+            fprintf(stderr, "Vazamento: %zu alocacoes (%zu bytes) de %s ainda vivas ao sair.\n",
+                    vivas, atomic_load(&memContas[e].bytes), descricoes[e]);
+        }
+    }
+    fflush(stderr);
+}
+
+#else /* !DQ_MEMORIA */
+
+static inline void *memAlocar(EtiquetaMem e, size_t n) { (void)e; return malloc(n); }
+static inline void *memZerada(EtiquetaMem e, size_t q, size_t t) { (void)e; return calloc(q, t); }
+static inline void *memRealocar(EtiquetaMem e, void *p, size_t n) { (void)e; return realloc(p, n); }
+static inline void *memAlinhada(EtiquetaMem e, size_t alinhamento, size_t n) {
+    (void)e;
+    return aligned_alloc(alinhamento, (n + alinhamento - 1) / alinhamento * alinhamento);
+}
+static inline void memLiberar(void *p) { free(p); }
+
+#define MEM_ARENA_CAMPO
+#define MEM_ARENA_INICIAR(b)          ((void)0)
+#define MEM_ARENA_CONTAR(a, e, n)     ((void)(e))
+#define MEM_ARENA_DESCONTAR(a)        ((void)0)
+
+static inline void memAtivar(const char *programa) {
+    (void)programa;
+    fprintf(stderr, "--memoria: compilado sem -DDQ_MEMORIA, nada a contar.\n");
+}
+
+static inline void memEncerrar(void) {}
+
+#endif /* DQ_MEMORIA */
+
+#endif /* A5_MEMORIA_H */
@@ -0,0 +1,284 @@
+#define _POSIX_C_SOURCE 200809L  /* sigaction (A5_estatisticas.h) */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DQ_SEM_MAIN
+#include "A5_detetiveMestre.c"
+
+/* ============================================================
+   Detective Quest - Testes de regressão
+   ------------------------------------------------------------
+   Casos que já quebraram, conferidos direto nas funções do
+   capítulo Mestre (incluído com DQ_SEM_MAIN, como no benchmark):
+
+   - casoValidar: deslocamentos de seção que dão a volta em 64
+     bits (off + num * tamanho) são recusados na abertura.
+   - --replay: sessões maiores que 512 bytes (e que o pedaço de
+     leitura) dão o mesmo registro no modo sequencial e com
+     --threads, sem truncar os movimentos nem o acusado.
+   - --resolver -> --replay: o caminho de cada suspeito, repetido
+     como roteiro (inclusive os de milhares de movimentos de uma
+     mansão degenerada), dá o mesmo veredito, a mesma contagem e
+     a mesma sala final que o resolvedor anunciou.
+
+   Uso:
+     gcc -std=c11 -O2 -pthread -o testeRegressao A5_testeRegressao.c
+     ./testeRegressao        (sai com 0 se tudo passou)
+   Os arquivos temporários (.dqc) ficam no diretório atual e são
+   apagados ao fim.
+   ============================================================ */
+
+static int falhas = 0;
+
+#define CONFERIR(cond, ...) \
+    do { \
+        if (!(cond)) { \
+            ++falhas; \
+            fprintf(stderr, "FALHOU (linha %d): ", __LINE__); \
+            fprintf(stderr, __VA_ARGS__); \
+            fputc('\n', stderr); \
+        } \
+    } while (0)
+
+#define ARQ_CASO   "testeRegressao_caso.dqc"
+#define ARQ_MEXIDO "testeRegressao_mexido.dqc"
+
+/* Grava a mansão embutida em ARQ_CASO. */
+static void gravarMansaoEmbutida(void) {
+    Arena arena = { NULL, NULL };
+    Sala *mapa = montarMapa(&arena);
+    HashTable *ht = criarHash(101);
+    popularMapaPistas(ht);
+    CONFERIR(exportarCaso(mapa, ht, ARQ_CASO) == 0, "exportarCaso falhou");
+    liberarHash(ht);
+    liberarInternos();
+    arenaLiberar(&arena);
+}
+
+static unsigned char *lerArquivo(const char *caminho, size_t *tam) {
+    FILE *f = fopen(caminho, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    *tam = (size_t)ftell(f);
+    fseek(f, 0, SEEK_SET);
+    unsigned char *dados = (unsigned char *)malloc(*tam);
+    if (dados && fread(dados, 1, *tam, f) != *tam) {
+        free(dados);
+        dados = NULL;
+    }
+    fclose(f);
+    return dados;
+}
+
+static void gravarArquivo(const char *caminho, const unsigned char *dados, size_t tam) {
+    FILE *f = fopen(caminho, "wb");
+    CONFERIR(f && fwrite(dados, 1, tam, f) == tam, "nao gravou %s", caminho);
+    if (f) fclose(f);
+}
+
+/* ------------------ casoValidar: volta em 64 bits ------------------ */
+static void testarDeslocamentosComVolta(void) {
+    size_t tam = 0;
+    unsigned char *original = lerArquivo(ARQ_CASO, &tam);
+    CONFERIR(original != NULL, "nao leu %s", ARQ_CASO);
+    if (!original) return;
+
+    CasoBinario c;
+    CONFERIR(abrirCaso(ARQ_CASO, &c) == 0, "o caso intacto deveria abrir");
+    fecharCaso(&c);
+
+    /* cada seção com off = 2^64 - 16 (a soma volta para 0 + ...), e
+       contagens grandes demais para o espaço depois de um off válido */
+    for (int caso = 0; caso < 6; ++caso) {
+        unsigned char *mexido = (unsigned char *)malloc(tam);
+        memcpy(mexido, original, tam);
+        CasoCabecalho h;
+        memcpy(&h, mexido, sizeof(h));
+        switch (caso) {
+            case 0: h.offSalas     = UINT64_MAX - 15; break;
+            case 1: h.offPistas    = UINT64_MAX - 15; break;
+            case 2: h.offSuspeitos = UINT64_MAX - 15; break;
+            case 3: h.numSalas     = UINT32_MAX;      break;
+            case 4: h.numPistas    = UINT32_MAX;      break;
+            case 5: h.numSuspeitos = UINT32_MAX;      break;
+        }
+        memcpy(mexido, &h, sizeof(h));
+        gravarArquivo(ARQ_MEXIDO, mexido, tam);
+        free(mexido);
+        int r = abrirCaso(ARQ_MEXIDO, &c);
+        CONFERIR(r != 0, "cabecalho mexido %d foi aceito", caso);
+        if (r == 0) fecharCaso(&c);
+    }
+    remove(ARQ_MEXIDO);
+    free(original);
+}
+
+/* Roda os roteiros (texto) sobre t e devolve os registros (malloc). */
+static char *rodarRoteiros(const char *roteiros, const Tabuleiro *t, int numThreads) {
+    FILE *in = tmpfile(), *out = tmpfile();
+    CONFERIR(in && out, "tmpfile falhou");
+    if (!in || !out) exit(EXIT_FAILURE);
+    fputs(roteiros, in);
+    rewind(in);
+#ifndef _WIN32
+    if (numThreads > 1) executarRoteirosParalelo(in, out, t, numThreads);
+    else
+#endif
+    executarRoteiros(in, out, t);
+    long tam = ftell(out);
+    rewind(out);
+    char *texto = (char *)malloc((size_t)tam + 1);
+    size_t lidos = fread(texto, 1, (size_t)tam, out);
+    texto[lidos] = '\0';
+    fclose(in);
+    fclose(out);
+    return texto;
+}
+
+/* ------------- --replay: sessões longas, sequencial x paralelo ------------- */
+static void testarRoteirosLongos(void) {
+    CasoBinario caso;
+    CONFERIR(abrirCaso(ARQ_CASO, &caso) == 0, "nao abriu %s", ARQ_CASO);
+    Tabuleiro t = { &caso, NULL, NULL };
+
+    /* 700 letras inválidas (cada uma revisita a sala) antes do trajeto,
+       uma de 5000 com o acusado no fim, CRLF e a última sem '\n' */
+    size_t tam = 16384;
+    char *roteiros = (char *)malloc(tam);
+    char *p = roteiros;
+    p += sprintf(p, "# comentario\needd Jardineiro\n\n");
+    memset(p, 'x', 700);
+    p += 700;
+    p += sprintf(p, "eedd Jardineiro\n");
+    p += sprintf(p, "ee");
+    memset(p, 'x', 5000);
+    p += 5000;
+    p += sprintf(p, " Jardineiro\r\n");
+    memset(p, 'e', 600);
+    p += 600;
+    sprintf(p, " Cozinheira");
+
+    char *seq = rodarRoteiros(roteiros, &t, 1);
+    CONFERIR(strstr(seq, "2;CULPADO;701;703;") != NULL,
+             "sessao de 700+ bytes truncada no modo sequencial:\n%s", seq);
+    CONFERIR(strstr(seq, "4;") != NULL, "ultima sessao (sem '\\n') perdida:\n%s", seq);
+#ifndef _WIN32
+    char *par = rodarRoteiros(roteiros, &t, 2);
+    CONFERIR(strcmp(seq, par) == 0, "sequencial e paralelo divergem:\n%s---\n%s", seq, par);
+    free(par);
+#endif
+    free(seq);
+    free(roteiros);
+    fecharCaso(&caso);
+}
+
+/* ------------------ --resolver -> --replay: ida e volta ------------------ */
+#define MAX_SUSPEITOS_TESTE 64
+
+typedef struct Esperado {
+    char prefixo[160];   /* "n;VEREDITO;contra;" */
+    char fim[160];       /* ";sala final\n" */
+} Esperado;
+
+/* Resolve t->caso, repete cada caminho anunciado como roteiro "caminho
+   acusado" e confere o registro de cada sessão com o anúncio. */
+static void conferirIdaEVolta(const Tabuleiro *t, const char *rotulo) {
+    FILE *sol = tmpfile();
+    CONFERIR(sol != NULL, "tmpfile falhou");
+    if (!sol) return;
+    resolverMansao(NULL, NULL, t->caso, 1, sol);
+    long tamSol = ftell(sol);
+    rewind(sol);
+    char *texto = (char *)malloc((size_t)tamSol + 1);
+    texto[fread(texto, 1, (size_t)tamSol, sol)] = '\0';
+    fclose(sol);
+
+    char *roteiros = (char *)malloc((size_t)tamSol + 1);
+    size_t tamRot = 0, n = 0, maiorCaminho = 0;
+    Esperado *esperados = (Esperado *)calloc(MAX_SUSPEITOS_TESTE, sizeof(Esperado));
+    for (char *l = texto; *l && n < MAX_SUSPEITOS_TESTE;) {
+        char *fimLinha = strchr(l, '\n');
+        if (fimLinha) *fimLinha = '\0';
+        /* "- NOME: N pista(s) -> STATUS; caminho: CAMINHO (termina em SALA)" */
+        char *sep = strstr(l, ": "), *seta = strstr(l, " -> ");
+        char *cam = strstr(l, "; caminho: "), *termina = strstr(l, " (termina em ");
+        if (strncmp(l, "- ", 2) == 0 && sep && seta && cam && termina) {
+            int pistas = atoi(sep + 2);
+            int condena = strncmp(seta + 4, "CONDENAVEL", 10) == 0;
+            *sep = '\0';
+            cam += 11;
+            *termina = '\0';
+            char *sala = termina + 13;
+            sala[strlen(sala) - 1] = '\0';  /* o ')' final */
+            size_t tamCam = strlen(cam);
+            if (tamCam > maiorCaminho) maiorCaminho = tamCam;
+            /* caminho vazio ("-"): 's' encerra a sessão no Hall */
+            tamRot += (size_t)sprintf(roteiros + tamRot, "%s %s\n", strcmp(cam, "-") ? cam : "s", l + 2);
+            /* 1 pista + 'x' revisitando = 2 contra */
+            snprintf(esperados[n].prefixo, sizeof(esperados[n].prefixo), "%zu;%s;%d;",
+                     n + 1, condena ? "CULPADO" : "INSUFICIENTE", pistas == 1 ? 2 : pistas);
+            snprintf(esperados[n].fim, sizeof(esperados[n].fim), ";%s\n", sala);
+            ++n;
+        }
+        l = fimLinha ? fimLinha + 1 : l + strlen(l);
+    }
+    CONFERIR(n > 0, "%s: resolvedor sem caminhos", rotulo);
+
+    char *registros = rodarRoteiros(roteiros, t, 1);
+    char *r = registros;
+    for (size_t i = 0; i < n; ++i) {
+        char *fimReg = strchr(r, '\n');
+        CONFERIR(fimReg != NULL, "%s: faltou o registro %zu", rotulo, i + 1);
+        if (!fimReg) break;
+        size_t tamReg = (size_t)(fimReg + 1 - r), tamFim = strlen(esperados[i].fim);
+        CONFERIR(strncmp(r, esperados[i].prefixo, strlen(esperados[i].prefixo)) == 0 &&
+                 tamReg >= tamFim && strncmp(fimReg + 1 - tamFim, esperados[i].fim, tamFim) == 0,
+                 "%s: registro %.*s, esperado %s...%s", rotulo, (int)(tamReg - 1), r,
+                 esperados[i].prefixo, esperados[i].fim);
+        r = fimReg + 1;
+    }
+    printf("%s: %zu caminho(s) repetidos, o maior com %zu movimentos\n", rotulo, n, maiorCaminho);
+    free(registros);
+    free(esperados);
+    free(roteiros);
+    free(texto);
+}
+
+static void testarResolverEReplay(void) {
+    CasoBinario caso;
+    CONFERIR(abrirCaso(ARQ_CASO, &caso) == 0, "nao abriu %s", ARQ_CASO);
+    casoOrdenarPistas(&caso);
+    Tabuleiro t = { &caso, NULL, NULL };
+    conferirIdaEVolta(&t, "mansao embutida");
+    fecharCaso(&caso);
+
+    /* degenerada: caminhos de milhares de movimentos */
+    ParametrosMansao params;
+    CONFERIR(lerParametrosMansao("degenerada:3000:7", &params) == 0, "parametros recusados");
+    HashTable *ht = criarHash(params.suspeitos * PISTAS_POR_SUSPEITO * 2);
+    MansaoGerada gerada = gerarMansao(&params, ht, 1);
+    ordenarInternos();
+    memset(&caso, 0, sizeof(caso));
+    compactarMansao(gerada.raiz, ht, &caso);
+    liberarHash(ht);
+    liberarInternos();
+    liberarMansaoGerada(&gerada);
+    conferirIdaEVolta(&t, "degenerada:3000:7");
+    fecharCaso(&caso);
+}
+
+int main(void) {
+    gravarMansaoEmbutida();
+    testarDeslocamentosComVolta();
+    testarRoteirosLongos();
+    testarResolverEReplay();
+    remove(ARQ_CASO);
+
+    if (falhas) {
+        fprintf(stderr, "%d falha(s).\n", falhas);
+        return EXIT_FAILURE;
+    }
+    printf("testeRegressao: tudo certo.\n");
+    return 0;
+}